@@ -0,0 +1,84 @@
+#ifndef BENCH_HPP_
+#define BENCH_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+// each sample is the mean of a batch of calls, as a single call is often too short to time
+struct Stats
+{
+    size_t iterations{ 0 };
+    double mean_ns{ 0.0 };
+    double median_ns{ 0.0 };
+    double p99_ns{ 0.0 };
+};
+
+// calls func the given number of times and returns the mean time per call in nanoseconds
+template <typename Func>
+auto mean_ns(size_t iterations, Func&& func) -> double;
+// times the given number of batches of calls to func, after an untimed batch to warm up
+template <typename Func>
+auto sample_ns(size_t samples, size_t batch_size, Func&& func) -> Stats;
+[[nodiscard]] auto stats(std::vector<double> samples, size_t batch_size) -> Stats;
+// reports are printed, and kept to be written out by write_json
+auto report(std::string_view name, size_t iterations, double mean_ns) -> void;
+auto report(std::string_view name, Stats const& stats) -> void;
+[[nodiscard]] auto write_json(std::filesystem::path const& path) -> bool;
+
+auto archetypes() -> void;
+auto collision() -> void;
+// return false if a correctness check failed
+auto entities() -> bool;
+auto world() -> bool;
+auto jobs() -> bool;
+auto scheduler() -> bool;
+auto simd() -> bool;
+auto snapshot() -> bool;
+auto spatial() -> bool;
+} // namespace bench
+
+/****************************
+ *                          *
+ * TEMPLATE IMPLEMENTATIONS *
+ *                          *
+ ****************************/
+
+namespace bench
+{
+template <typename Func>
+auto mean_ns(const size_t iterations, Func&& func) -> double
+{
+    const auto start{ std::chrono::steady_clock::now() };
+    for (size_t i{ 0 }; i < iterations; i++)
+    {
+        func();
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed{ std::chrono::steady_clock::now() - start };
+
+    return elapsed.count() / static_cast<double>(iterations);
+}
+
+template <typename Func>
+auto sample_ns(const size_t samples, const size_t batch_size, Func&& func) -> Stats
+{
+    std::vector<double> times;
+    times.reserve(samples);
+    std::ignore = mean_ns(batch_size, func);
+    for (size_t i{ 0 }; i < samples; i++)
+    {
+        times.push_back(mean_ns(batch_size, func));
+    }
+
+    return stats(std::move(times), batch_size);
+}
+} // namespace bench
+
+#endif
@@ -0,0 +1,147 @@
+#include "bench.hpp"
+#include "se-archetypes.hpp"
+#include "se-components.hpp"
+
+#include <algorithm>
+#include <format>
+#include <ranges>
+#include <span>
+
+namespace ranges = std::ranges;
+namespace views = std::views;
+namespace se = seb_engine;
+
+namespace
+{
+struct Lifespan
+{
+    float remaining{ 0.0 };
+};
+
+inline constexpr size_t CHUNK_SIZE{ 1024 };
+inline constexpr size_t ENTITY_TICKS{ 10000000 };
+inline constexpr float DT{ 1.0 / 60.0 };
+inline constexpr float LIFESPAN{ 1.0e6 };
+
+template <size_t EntityCount>
+auto components_tick() -> void;
+template <size_t EntityCount>
+auto archetypes_tick() -> void;
+} // namespace
+
+namespace bench
+{
+auto archetypes() -> void
+{
+    components_tick<1000>();   // NOLINT(*magic-numbers)
+    archetypes_tick<1000>();   // NOLINT(*magic-numbers)
+    components_tick<10000>();  // NOLINT(*magic-numbers)
+    archetypes_tick<10000>();  // NOLINT(*magic-numbers)
+    components_tick<100000>(); // NOLINT(*magic-numbers)
+    archetypes_tick<100000>(); // NOLINT(*magic-numbers)
+}
+} // namespace bench
+
+// every entity has a position, every second entity moves and every fourth entity has a lifespan
+// each tick runs the same work as Game::move and Game::update_lifespans
+namespace
+{
+template <size_t EntityCount>
+auto components_tick() -> void
+{
+    se::Components<se::Pos, se::Vel, Lifespan> components;
+    components.template reg<Lifespan>(se::Storage::Sparse);
+    components.resize(EntityCount);
+    for (size_t id{ 0 }; id < EntityCount; id++)
+    {
+        components.template add<se::Pos>(id) = se::Pos{ static_cast<float>(id), 0.0 };
+        if (id % 2 == 0)
+        {
+            components.template add<se::Vel>(id) = se::Vel{ 1.0, 1.0 };
+        }
+
+        if (id % 4 == 0)
+        {
+            components.template add<Lifespan>(id).remaining = LIFESPAN;
+        }
+    }
+
+    volatile size_t sink{ 0 };
+    const auto ticks{ ENTITY_TICKS / EntityCount };
+    const auto ns{ bench::mean_ns(
+        ticks,
+        [&components, &sink]()
+        {
+            auto& pos{ components.template vec<se::Pos>() };
+            auto& vel{ components.template vec<se::Vel>() };
+            for (size_t page{ 0 }; page < pos.page_count(); page++)
+            {
+                const auto pos_page{ pos.page(page) };
+                ranges::transform(
+                    pos_page,
+                    vel.page(page),
+                    pos_page.begin(),
+                    [](const auto pos, const auto vel) { return pos + (vel * DT); }
+                );
+            }
+
+            size_t expired{ 0 };
+            for (const auto [id, lifespan] :
+                 views::zip(components.template owners<Lifespan>(), components.template vec<Lifespan>()))
+            {
+                lifespan.remaining -= DT;
+                expired += (lifespan.remaining < 0.0 ? 1 : 0);
+            }
+
+            sink = expired;
+        }
+    ) };
+    bench::report(std::format("Components tick with {} entities", EntityCount), ticks, ns);
+}
+
+template <size_t EntityCount>
+auto archetypes_tick() -> void
+{
+    se::Archetypes<CHUNK_SIZE, se::Pos, se::Vel, Lifespan> archetypes;
+    for (size_t id{ 0 }; id < EntityCount; id++)
+    {
+        archetypes.insert(id, se::Pos{ static_cast<float>(id), 0.0 });
+        if (id % 2 == 0)
+        {
+            archetypes.add(id, se::Vel{ 1.0, 1.0 });
+        }
+
+        if (id % 4 == 0)
+        {
+            archetypes.add(id, Lifespan{ LIFESPAN });
+        }
+    }
+
+    volatile size_t sink{ 0 };
+    const auto ticks{ ENTITY_TICKS / EntityCount };
+    const auto ns{ bench::mean_ns(
+        ticks,
+        [&archetypes, &sink]()
+        {
+            archetypes.template each_chunk<se::Pos, se::Vel>(
+                [](std::span<const size_t>, const std::span<se::Pos> pos, const std::span<se::Vel> vel)
+                {
+                    ranges::transform(
+                        pos, vel, pos.begin(), [](const auto pos, const auto vel) { return pos + (vel * DT); }
+                    );
+                }
+            );
+            size_t expired{ 0 };
+            archetypes.template each<Lifespan>(
+                [&expired](size_t, Lifespan& lifespan)
+                {
+                    lifespan.remaining -= DT;
+                    expired += (lifespan.remaining < 0.0 ? 1 : 0);
+                }
+            );
+            sink = expired;
+        }
+    ) };
+    bench::report(std::format("Archetypes tick with {} entities", EntityCount), ticks, ns);
+}
+} // namespace
@@ -0,0 +1,142 @@
+#include "bench.hpp"
+#include "se-bbox.hpp"
+#include "sl-math.hpp"
+
+#include <cstddef>
+#include <format>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace se = seb_engine;
+namespace sm = seblib::math;
+namespace rl = raylib;
+
+namespace
+{
+// a power of two, so indices wrap with a mask
+inline constexpr size_t SHAPE_COUNT{ 1024 };
+inline constexpr size_t SAMPLES{ 200 };
+inline constexpr size_t BATCH_SIZE{ 10000 };
+inline constexpr unsigned SEED{ 1234 };
+// shapes are scattered over an area a few times their size, so roughly half of the checks collide
+inline constexpr float AREA_LEN{ 128.0 };
+inline constexpr float MAX_SHAPE_LEN{ 48.0 };
+
+struct Shapes
+{
+    std::vector<rl::Rectangle> rectangles;
+    std::vector<sm::Circle> circles;
+    std::vector<sm::Line> lines;
+    // a mix of all three, as bboxes are in Game
+    std::vector<se::BBoxVariant> variants;
+
+    Shapes();
+};
+
+template <typename Shape1, typename Shape2>
+auto check_collision(std::string_view name, std::vector<Shape1> const& shapes1, std::vector<Shape2> const& shapes2)
+    -> void;
+template <typename Func>
+auto pairs(std::string_view name, std::vector<se::BBoxVariant> const& bboxes, Func&& func) -> void;
+} // namespace
+
+namespace bench
+{
+auto collision() -> void
+{
+    const Shapes shapes;
+    check_collision("Rectangle x Rectangle", shapes.rectangles, shapes.rectangles);
+    check_collision("Rectangle x Circle", shapes.rectangles, shapes.circles);
+    check_collision("Rectangle x Line", shapes.rectangles, shapes.lines);
+    check_collision("Circle x Rectangle", shapes.circles, shapes.rectangles);
+    check_collision("Circle x Circle", shapes.circles, shapes.circles);
+    check_collision("Circle x Line", shapes.circles, shapes.lines);
+    check_collision("Line x Rectangle", shapes.lines, shapes.rectangles);
+    check_collision("Line x Circle", shapes.lines, shapes.circles);
+    check_collision("Line x Line", shapes.lines, shapes.lines);
+
+    volatile bool collides_sink{ false };
+    pairs(
+        "bbox::collides (mixed)",
+        shapes.variants,
+        [&collides_sink](se::BBoxVariant const& bbox1, se::BBoxVariant const& bbox2)
+        { collides_sink = se::bbox::collides(bbox1, bbox2); }
+    );
+
+    // resolving is only done against tiles, which are rectangles
+    std::vector<se::BBoxVariant> rectangles{ shapes.rectangles.begin(), shapes.rectangles.end() };
+    volatile float resolve_sink{ 0.0 };
+    pairs(
+        "bbox::resolve_collision (rectangles)",
+        rectangles,
+        [&resolve_sink](se::BBoxVariant const& bbox1, se::BBoxVariant const& bbox2)
+        { resolve_sink = se::bbox::resolve_collision(bbox1, bbox2).x; }
+    );
+}
+} // namespace bench
+
+namespace
+{
+Shapes::Shapes()
+{
+    std::mt19937 rng{ SEED };
+    std::uniform_real_distribution<float> coord{ 0.0, AREA_LEN };
+    std::uniform_real_distribution<float> len{ 1.0, MAX_SHAPE_LEN };
+    std::uniform_real_distribution<float> angle{ 0.0, 360.0 }; // NOLINT(*magic-numbers)
+    for (size_t i{ 0 }; i < SHAPE_COUNT; i++)
+    {
+        rectangles.push_back(rl::Rectangle{ coord(rng), coord(rng), len(rng), len(rng) });
+        circles.emplace_back(sm::Vec2{ coord(rng), coord(rng) }, len(rng) / 2);
+        lines.emplace_back(sm::Vec2{ coord(rng), coord(rng) }, len(rng), angle(rng));
+        switch (i % 3)
+        {
+        case 0:
+            variants.emplace_back(rectangles.back());
+            break;
+        case 1:
+            variants.emplace_back(circles.back());
+            break;
+        default:
+            variants.emplace_back(lines.back());
+            break;
+        }
+    }
+}
+
+// each call checks the next pair, offset so a shape is never checked against itself
+template <typename Shape1, typename Shape2>
+auto check_collision(
+    const std::string_view name, std::vector<Shape1> const& shapes1, std::vector<Shape2> const& shapes2
+) -> void
+{
+    volatile bool sink{ false };
+    size_t i{ 0 };
+    const auto stats{ bench::sample_ns(
+        SAMPLES,
+        BATCH_SIZE,
+        [&]()
+        {
+            sink = sm::check_collision(shapes1[i], shapes2[(i + 1) & (SHAPE_COUNT - 1)]);
+            i = (i + 1) & (SHAPE_COUNT - 1);
+        }
+    ) };
+    bench::report(std::format("check_collision {}", name), stats);
+}
+
+template <typename Func>
+auto pairs(const std::string_view name, std::vector<se::BBoxVariant> const& bboxes, Func&& func) -> void
+{
+    size_t i{ 0 };
+    const auto stats{ bench::sample_ns(
+        SAMPLES,
+        BATCH_SIZE,
+        [&]()
+        {
+            func(bboxes[i], bboxes[(i + 1) & (SHAPE_COUNT - 1)]);
+            i = (i + 1) & (SHAPE_COUNT - 1);
+        }
+    ) };
+    bench::report(name, stats);
+}
+} // namespace
@@ -0,0 +1,267 @@
+#include "bench.hpp"
+#include "se-components.hpp"
+#include "se-entities.hpp"
+#include "se-prefab.hpp"
+#include "sl-log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <format>
+#include <random>
+#include <tuple>
+#include <ranges>
+#include <vector>
+
+namespace views = std::views;
+namespace se = seb_engine;
+namespace slog = seblib::log;
+
+namespace
+{
+enum class BenchEntity : uint8_t
+{
+    None = 0,
+
+    Thing,
+};
+
+inline constexpr size_t SMALL_MAX_ENTITIES{ 1024 };
+inline constexpr size_t LARGE_MAX_ENTITIES{ 16384 };
+inline constexpr size_t ITERATIONS{ 100000 };
+inline constexpr size_t SAMPLES{ 100 };
+inline constexpr unsigned SEED{ 1234 };
+inline constexpr std::array OCCUPANCY_PCTS{ 10U, 50U, 95U };
+inline constexpr size_t WAVE_SIZE{ 500 };
+inline constexpr size_t WAVE_ITERATIONS{ 1000 };
+// roughly what combat spawns and destroys in a tick
+inline constexpr size_t CHURN_PER_TICK{ 20 };
+
+struct Health
+{
+    int current{ 0 };
+    int max{ 0 };
+};
+
+using BenchComponents = se::Components<se::Pos, se::Vel, Health>;
+
+// prefabs without sprite parts never touch the sprites they are written with
+struct NoSprites
+{
+};
+
+auto spawn_destroy(size_t max_entities, unsigned occupancy_pct) -> void;
+auto spawn_wave(bool batched) -> void;
+template <typename Comp, typename Field>
+auto components_get(se::Storage storage, Field field) -> void;
+auto view_churn() -> bool;
+} // namespace
+
+namespace bench
+{
+auto entities() -> bool
+{
+    for (const auto occupancy_pct : OCCUPANCY_PCTS)
+    {
+        spawn_destroy(SMALL_MAX_ENTITIES, occupancy_pct);
+        spawn_destroy(LARGE_MAX_ENTITIES, occupancy_pct);
+    }
+
+    spawn_wave(false);
+    spawn_wave(true);
+    components_get<se::Pos>(se::Storage::Dense, [](se::Pos const& pos) { return pos.x; });
+    components_get<Health>(se::Storage::Sparse, [](Health const& health) { return health.current; });
+
+    return view_churn();
+}
+} // namespace bench
+
+namespace
+{
+// fills the table, then destroys a random subset so the free slots are scattered as they would be mid-game
+auto spawn_destroy(const size_t max_entities, const unsigned occupancy_pct) -> void
+{
+    se::Entities<BenchEntity> entities{ max_entities };
+    std::vector<size_t> ids;
+    ids.reserve(max_entities);
+    for (size_t i{ 0 }; i < max_entities; i++)
+    {
+        ids.push_back(entities.spawn(BenchEntity::Thing));
+    }
+
+    std::mt19937 rng{ SEED };
+    std::ranges::shuffle(ids, rng);
+    for (const auto id : ids | views::drop(max_entities * occupancy_pct / 100)) // NOLINT(*magic-numbers)
+    {
+        entities.destroy(id);
+    }
+
+    volatile size_t sink{ 0 };
+    const auto stats{ bench::sample_ns(
+        SAMPLES,
+        ITERATIONS / SAMPLES,
+        [&entities, &sink]()
+        {
+            const auto id{ entities.spawn(BenchEntity::Thing) };
+            entities.destroy(id);
+            sink = id;
+        }
+    ) };
+    bench::report(
+        std::format("Entities ({} max) spawn + destroy at {}% occupancy", max_entities, occupancy_pct), stats
+    );
+}
+
+// spawns a wave of identical entities and then destroys it, either one entity at a time or as a single batch
+auto spawn_wave(const bool batched) -> void
+{
+    se::Entities<BenchEntity> entities{ LARGE_MAX_ENTITIES };
+    BenchComponents components;
+    NoSprites sprites;
+    const se::Prefab prefab{
+        BenchEntity::Thing,
+        std::tuple{ se::Pos{ 1.0, 2.0 }, se::Vel{}, Health{ .current = 100, .max = 100 } },
+        std::tuple{},
+    };
+    std::vector<size_t> ids;
+    const auto ns{ bench::mean_ns(
+        WAVE_ITERATIONS,
+        [&]()
+        {
+            if (batched)
+            {
+                ids = entities.spawn_batch(BenchEntity::Thing, WAVE_SIZE);
+                components.resize(entities.capacity());
+                prefab.write(ids, components, sprites);
+            }
+            else
+            {
+                ids.clear();
+                for (size_t i{ 0 }; i < WAVE_SIZE; i++)
+                {
+                    const auto id{ entities.spawn(BenchEntity::Thing) };
+                    components.resize(entities.capacity());
+                    components.add<se::Pos>(id) = se::Pos{ 1.0, 2.0 };
+                    components.add<se::Vel>(id) = se::Vel{};
+                    components.add<Health>(id) = Health{ .current = 100, .max = 100 };
+                    ids.push_back(id);
+                }
+            }
+
+            for (const auto id : ids)
+            {
+                components.uninit(id);
+                entities.destroy(id);
+            }
+        }
+    ) };
+    bench::report(
+        std::format("Spawn + destroy wave of {} ({})", WAVE_SIZE, batched ? "batched" : "one at a time"),
+        WAVE_ITERATIONS,
+        ns
+    );
+}
+
+// reads a field of random entities' components, as systems looking up other entities do
+// every other entity has the component, so sparse storage isn't packed in id order
+template <typename Comp, typename Field>
+auto components_get(const se::Storage storage, Field field) -> void
+{
+    BenchComponents components;
+    components.reg<Comp>(storage);
+    components.resize(LARGE_MAX_ENTITIES);
+    for (size_t id{ 0 }; id < LARGE_MAX_ENTITIES; id += 2)
+    {
+        components.add<Comp>(id) = Comp{};
+    }
+
+    std::mt19937 rng{ SEED };
+    std::uniform_int_distribution<size_t> id_dist{ 0, (LARGE_MAX_ENTITIES / 2) - 1 };
+    std::vector<size_t> ids(LARGE_MAX_ENTITIES);
+    std::ranges::generate(ids, [&]() { return id_dist(rng) * 2; });
+    size_t i{ 0 };
+    volatile decltype(field(Comp{})) sink{};
+    const auto stats{ bench::sample_ns(
+        SAMPLES,
+        ITERATIONS / SAMPLES,
+        [&]()
+        {
+            i = (i + 1) % LARGE_MAX_ENTITIES;
+            sink = field(components.get<Comp>(ids[i]));
+        }
+    ) };
+    const auto storage_name{ storage == se::Storage::Dense ? "dense" : "sparse" };
+    bench::report(std::format("Components::get ({}, {} entities)", storage_name, LARGE_MAX_ENTITIES), stats);
+}
+
+// a few entities gain or lose components between reads of a view over a large table, as in a tick of combat, and the
+// views then have to list exactly the ids a scan of every entity finds
+auto view_churn() -> bool
+{
+    BenchComponents components;
+    components.reg<Health>(se::Storage::Sparse);
+    components.resize(LARGE_MAX_ENTITIES);
+    for (size_t id{ 0 }; id < LARGE_MAX_ENTITIES; id += 2)
+    {
+        components.add<se::Pos>(id);
+        components.add<se::Vel>(id);
+    }
+
+    std::mt19937 rng{ SEED };
+    std::uniform_int_distribution<size_t> id_dist{ 0, LARGE_MAX_ENTITIES - 1 };
+    volatile size_t sink{ 0 };
+    const auto stats{ bench::sample_ns(
+        SAMPLES,
+        1,
+        [&]()
+        {
+            for (size_t i{ 0 }; i < CHURN_PER_TICK; i++)
+            {
+                const auto id{ id_dist(rng) };
+                if (components.contains<se::Pos>(id))
+                {
+                    components.uninit(id);
+                }
+                else
+                {
+                    components.add<se::Pos>(id);
+                    components.add<se::Vel>(id);
+                    if (id % 3 == 0)
+                    {
+                        components.add<Health>(id);
+                    }
+                }
+            }
+
+            sink = sink + components.ids<se::Pos, se::Vel>().size() + components.ids<Health>().size();
+        }
+    ) };
+    bench::report(
+        std::format("Components::ids after {} changes ({} entities)", CHURN_PER_TICK * 2, LARGE_MAX_ENTITIES),
+        stats
+    );
+
+    std::vector<size_t> moving;
+    std::vector<size_t> healthy;
+    for (size_t id{ 0 }; id < LARGE_MAX_ENTITIES; id++)
+    {
+        if (components.contains<se::Pos>(id) && components.contains<se::Vel>(id))
+        {
+            moving.push_back(id);
+        }
+
+        if (components.contains<Health>(id))
+        {
+            healthy.push_back(id);
+        }
+    }
+
+    const auto matches{ components.ids<se::Pos, se::Vel>() == moving && components.ids<Health>() == healthy };
+    if (!matches)
+    {
+        slog::log(slog::ERR, "Components::ids differs from a scan of every entity");
+    }
+
+    return matches;
+}
+} // namespace
@@ -0,0 +1,274 @@
+#include "bench.hpp"
+#include "se-components.hpp"
+#include "sl-jobs.hpp"
+#include "sl-log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <thread>
+#include <vector>
+
+namespace se = seb_engine;
+namespace sj = seblib::jobs;
+namespace slog = seblib::log;
+
+namespace
+{
+inline constexpr size_t ELEMENT_COUNT{ 1 << 20 };
+inline constexpr size_t ITERATIONS{ 20 };
+inline constexpr std::array GRAINS{ 256UZ, 4096UZ, 65536UZ };
+inline constexpr size_t CHAIN_LENGTH{ 1000 };
+inline constexpr std::array ENTITY_COUNTS{ 10000UZ, 100000UZ };
+inline constexpr size_t CHUNK_SIZE{ 4096 };
+inline constexpr size_t TICKS{ 100 };
+inline constexpr float DT{ 1.0 / 60.0 };
+
+struct Lifespan
+{
+    float remaining{ 0.0 };
+};
+
+using BenchComponents = se::Components<se::Pos, se::Vel, Lifespan>;
+
+auto kernel(std::vector<float>& values, size_t first, size_t last) -> void;
+auto scaling(size_t threads, size_t grain, double single_thread_ns) -> double;
+auto init(BenchComponents& components, size_t entity_count) -> void;
+auto tick(BenchComponents& components, sj::Pool& pool, std::vector<size_t>& expired) -> void;
+auto par_each_scaling(size_t entity_count, size_t threads, double single_thread_ns) -> double;
+auto parallel_for_correct() -> bool;
+auto par_each_correct() -> bool;
+auto dependencies_correct() -> bool;
+} // namespace
+
+namespace bench
+{
+// scales parallel_for from one thread up to every hardware thread, followed by checks of its results and of job
+// dependencies
+auto jobs() -> bool
+{
+    const auto max_threads{ std::max(std::thread::hardware_concurrency(), 1U) };
+    for (const auto grain : GRAINS)
+    {
+        const auto single_thread_ns{ scaling(1, grain, 0.0) };
+        for (size_t threads{ 2 }; threads <= max_threads; threads *= 2)
+        {
+            scaling(threads, grain, single_thread_ns);
+        }
+
+        if (!std::has_single_bit(max_threads) && max_threads > 1)
+        {
+            scaling(max_threads, grain, single_thread_ns);
+        }
+    }
+
+    for (const auto entity_count : ENTITY_COUNTS)
+    {
+        const auto single_thread_ns{ par_each_scaling(entity_count, 1, 0.0) };
+        for (size_t threads{ 2 }; threads <= max_threads; threads *= 2)
+        {
+            par_each_scaling(entity_count, threads, single_thread_ns);
+        }
+
+        if (!std::has_single_bit(max_threads) && max_threads > 1)
+        {
+            par_each_scaling(entity_count, max_threads, single_thread_ns);
+        }
+    }
+
+    const auto parallel_for_ok{ parallel_for_correct() };
+    const auto par_each_ok{ par_each_correct() };
+    const auto dependencies_ok{ dependencies_correct() };
+
+    return parallel_for_ok && par_each_ok && dependencies_ok;
+}
+} // namespace bench
+
+namespace
+{
+// enough work per element for the split across threads to matter
+auto kernel(std::vector<float>& values, const size_t first, const size_t last) -> void
+{
+    for (auto i{ first }; i < last; i++)
+    {
+        values[i] = std::sqrt(values[i] * values[i] + 1.0F) * std::sin(values[i]);
+    }
+}
+
+// the calling thread takes part, so a pool for n threads has n - 1 workers
+auto scaling(const size_t threads, const size_t grain, const double single_thread_ns) -> double
+{
+    sj::Pool pool{ threads - 1 };
+    pool.reserve(ELEMENT_COUNT / grain);
+    std::vector<float> values(ELEMENT_COUNT, 1.0);
+    const auto ns{ bench::mean_ns(
+        ITERATIONS,
+        [&]()
+        {
+            pool.parallel_for(
+                0,
+                ELEMENT_COUNT,
+                grain,
+                [&values](const size_t first, const size_t last) { kernel(values, first, last); }
+            );
+        }
+    ) };
+    const auto speedup{ single_thread_ns > 0.0 ? single_thread_ns / ns : 1.0 };
+    bench::report(
+        std::format("parallel_for {} threads, grain {} ({:.2f}x)", threads, grain, speedup), ITERATIONS, ns
+    );
+
+    return ns;
+}
+
+// every entity moves, and every fourth entity has a lifespan which expires part way through
+auto init(BenchComponents& components, const size_t entity_count) -> void
+{
+    components.reg<Lifespan>(se::Storage::Sparse);
+    components.resize(entity_count);
+    for (size_t id{ 0 }; id < entity_count; id++)
+    {
+        components.add<se::Pos>(id) = se::Pos{ static_cast<float>(id), 0.0 };
+        components.add<se::Vel>(id) = se::Vel{ 1.0, static_cast<float>(id % 3) };
+        if (id % 4 == 0)
+        {
+            components.add<Lifespan>(id).remaining = static_cast<float>(id % TICKS) * DT;
+        }
+    }
+}
+
+// the same work as Game::move and Game::update_lifespans
+auto tick(BenchComponents& components, sj::Pool& pool, std::vector<size_t>& expired) -> void
+{
+    components.par_each<se::Pos, se::Vel>(
+        pool, CHUNK_SIZE, [](size_t, se::Pos& pos, const se::Vel vel) { pos += vel * DT; }
+    );
+    components.par_each<Lifespan>(
+        pool,
+        CHUNK_SIZE,
+        [](size_t, Lifespan& lifespan)
+        {
+            lifespan.remaining -= DT;
+
+            return lifespan.remaining < 0.0;
+        },
+        [&expired](const size_t id) { expired.push_back(id); }
+    );
+}
+
+auto par_each_scaling(const size_t entity_count, const size_t threads, const double single_thread_ns) -> double
+{
+    sj::Pool pool{ threads - 1 };
+    BenchComponents components;
+    init(components, entity_count);
+    std::vector<size_t> expired;
+    const auto ns{ bench::mean_ns(TICKS, [&]() { tick(components, pool, expired); }) };
+    const auto speedup{ single_thread_ns > 0.0 ? single_thread_ns / ns : 1.0 };
+    bench::report(
+        std::format("par_each {} entities, {} threads ({:.2f}x)", entity_count, threads, speedup), TICKS, ns
+    );
+
+    return ns;
+}
+
+// the smallest grain queues more jobs than a queue starts with room for, so this covers the queues growing too
+auto parallel_for_correct() -> bool
+{
+    std::vector<float> expected(ELEMENT_COUNT, 1.0);
+    kernel(expected, 0, ELEMENT_COUNT);
+
+    sj::Pool pool;
+    std::vector<float> values(ELEMENT_COUNT, 1.0);
+    std::atomic<size_t> visited{ 0 };
+    pool.parallel_for(
+        0,
+        ELEMENT_COUNT,
+        GRAINS.front(),
+        [&](const size_t first, const size_t last)
+        {
+            kernel(values, first, last);
+            visited += last - first;
+        }
+    );
+
+    const auto correct{ visited == ELEMENT_COUNT && values == expected };
+    if (!correct)
+    {
+        slog::log(slog::ERR, "parallel_for results differ from serial execution");
+    }
+
+    return correct;
+}
+
+// deferred ids have to come out in the same order however the chunks were spread across threads
+auto par_each_correct() -> bool
+{
+    const auto entity_count{ ENTITY_COUNTS.back() };
+    sj::Pool no_workers{ 0 };
+    sj::Pool pool;
+    BenchComponents serial;
+    BenchComponents parallel;
+    init(serial, entity_count);
+    init(parallel, entity_count);
+    std::vector<size_t> serial_expired;
+    std::vector<size_t> parallel_expired;
+    for (size_t i{ 0 }; i < TICKS; i++)
+    {
+        tick(serial, no_workers, serial_expired);
+        tick(parallel, pool, parallel_expired);
+    }
+
+    auto correct{ serial_expired == parallel_expired };
+    for (size_t id{ 0 }; correct && id < entity_count; id++)
+    {
+        const auto serial_pos{ serial.get<se::Pos>(id) };
+        const auto parallel_pos{ parallel.get<se::Pos>(id) };
+        correct = serial_pos.x == parallel_pos.x && serial_pos.y == parallel_pos.y;
+    }
+
+    if (!correct)
+    {
+        slog::log(slog::ERR, "par_each results differ from serial execution");
+    }
+
+    return correct;
+}
+
+// each job in the chain depends on the one before it, so they have to run in order even when spread over threads
+auto dependencies_correct() -> bool
+{
+    sj::Pool pool;
+    std::vector<sj::Counter> counters(CHAIN_LENGTH);
+    std::vector<size_t> order;
+    for (size_t i{ 0 }; i < CHAIN_LENGTH; i++)
+    {
+        auto job{ [&order, i]() { order.push_back(i); } };
+        if (i == 0)
+        {
+            pool.submit(job, &counters[i]);
+        }
+        else
+        {
+            pool.submit_after(counters[i - 1], job, &counters[i]);
+        }
+    }
+
+    pool.wait(counters.back());
+    auto correct{ order.size() == CHAIN_LENGTH };
+    for (size_t i{ 0 }; correct && i < CHAIN_LENGTH; i++)
+    {
+        correct = order[i] == i;
+    }
+
+    if (!correct)
+    {
+        slog::log(slog::ERR, "Dependent jobs ran out of order");
+    }
+
+    return correct;
+}
+} // namespace
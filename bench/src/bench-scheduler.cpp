@@ -0,0 +1,211 @@
+#include "bench.hpp"
+#include "se-components.hpp"
+#include "se-scheduler.hpp"
+#include "sl-jobs.hpp"
+#include "sl-log.hpp"
+
+#include <cstddef>
+#include <format>
+#include <random>
+#include <ranges>
+#include <string>
+#include <vector>
+
+namespace views = std::views;
+namespace se = seb_engine;
+namespace slog = seblib::log;
+namespace sj = seblib::jobs;
+
+namespace
+{
+struct Lifespan
+{
+    float remaining{ 0.0 };
+};
+
+struct Invuln
+{
+    float remaining{ 0.0 };
+};
+
+struct Flipped
+{
+    bool flipped{ false };
+};
+
+// stands in for Game, with the same kinds of systems
+struct Sim
+{
+    se::Components<se::Pos, se::Vel, Lifespan, Invuln, Flipped> components;
+    std::vector<size_t> expired;
+};
+
+inline constexpr size_t ENTITY_COUNT{ 50000 };
+inline constexpr size_t TICKS{ 200 };
+inline constexpr float DT{ 1.0 / 60.0 };
+inline constexpr float BOUNDS{ 1000.0 };
+inline constexpr float MAX_SPEED{ 100.0 };
+inline constexpr float MAX_TIME{ 3.0 };
+inline constexpr unsigned SEED{ 1234 };
+
+auto init(Sim& sim) -> void;
+auto scheduler() -> se::Scheduler<Sim>;
+auto same_state(Sim& sim1, Sim& sim2) -> bool;
+} // namespace
+
+namespace bench
+{
+// runs the same ticks serially and through the scheduler, failing if the results differ in any way
+auto scheduler() -> bool
+{
+    const auto sched{ ::scheduler() };
+    const auto stages{ sched.stages() };
+    for (size_t i{ 0 }; i < stages.size(); i++)
+    {
+        std::string names;
+        for (const auto name : stages[i])
+        {
+            names += std::format(" {}", name);
+        }
+
+        slog::log(slog::INF, "Stage {}:{}", i, names);
+    }
+
+    sj::Pool pool;
+    Sim serial;
+    Sim parallel;
+    init(serial);
+    init(parallel);
+    const auto serial_ns{ bench::mean_ns(TICKS, [&]() { sched.run_serial(serial); }) };
+    const auto parallel_ns{ bench::mean_ns(TICKS, [&]() { sched.run(parallel, pool); }) };
+    bench::report(std::format("Scheduler tick with {} entities (serial)", ENTITY_COUNT), TICKS, serial_ns);
+    bench::report(std::format("Scheduler tick with {} entities (parallel)", ENTITY_COUNT), TICKS, parallel_ns);
+
+    const auto same{ same_state(serial, parallel) };
+    if (!same)
+    {
+        slog::log(slog::ERR, "Scheduler results differ from serial execution");
+    }
+
+    return same;
+}
+} // namespace bench
+
+namespace
+{
+auto init(Sim& sim) -> void
+{
+    auto& components{ sim.components };
+    components.reg<Lifespan>(se::Storage::Sparse);
+    components.resize(ENTITY_COUNT);
+    std::mt19937 rng{ SEED };
+    std::uniform_real_distribution<float> pos{ 0.0, BOUNDS };
+    std::uniform_real_distribution<float> speed{ -MAX_SPEED, MAX_SPEED };
+    std::uniform_real_distribution<float> time{ 0.0, MAX_TIME };
+    for (size_t id{ 0 }; id < ENTITY_COUNT; id++)
+    {
+        components.add<se::Pos>(id) = se::Pos{ pos(rng), pos(rng) };
+        components.add<se::Vel>(id) = se::Vel{ speed(rng), speed(rng) };
+        components.add<Invuln>(id).remaining = time(rng);
+        components.add<Flipped>(id) = Flipped{};
+        if (id % 4 == 0)
+        {
+            components.add<Lifespan>(id).remaining = time(rng);
+        }
+    }
+}
+
+auto scheduler() -> se::Scheduler<Sim>
+{
+    using se::Reads;
+    using se::Writes;
+
+    se::Scheduler<Sim> scheduler;
+    scheduler.add<Reads<se::Vel, se::Signatures>, Writes<se::Pos>>(
+        "move",
+        [](Sim& sim)
+        {
+            for (const auto [id, pos, vel] : sim.components.view<se::Pos, se::Vel>())
+            {
+                pos += vel * DT;
+            }
+        }
+    );
+    scheduler.add<Reads<>, Writes<Lifespan, std::vector<size_t>>>(
+        "update_lifespans",
+        [](Sim& sim)
+        {
+            for (const auto [id, lifespan] :
+                 views::zip(sim.components.owners<Lifespan>(), sim.components.vec<Lifespan>()))
+            {
+                lifespan.remaining -= DT;
+                if (lifespan.remaining < 0.0)
+                {
+                    sim.expired.push_back(id);
+                }
+            }
+        }
+    );
+    scheduler.add<Reads<>, Writes<Invuln>>(
+        "update_invuln_times",
+        [](Sim& sim)
+        {
+            for (auto& invuln : sim.components.vec<Invuln>())
+            {
+                invuln.remaining -= (invuln.remaining > 0.0 ? DT : 0.0F);
+            }
+        }
+    );
+    scheduler.add<Reads<se::Vel, se::Signatures>, Writes<Flipped>>(
+        "set_flipped",
+        [](Sim& sim)
+        {
+            for (const auto [id, vel, flipped] : sim.components.view<se::Vel, Flipped>())
+            {
+                flipped.flipped = vel.x < 0.0;
+            }
+        }
+    );
+    // depends on both move and set_flipped, so has to wait for them
+    scheduler.add<Reads<se::Pos, se::Signatures>, Writes<se::Vel>>(
+        "bounce",
+        [](Sim& sim)
+        {
+            for (const auto [id, pos, vel] : sim.components.view<se::Pos, se::Vel>())
+            {
+                vel.x = ((pos.x < 0.0 && vel.x < 0.0) || (pos.x > BOUNDS && vel.x > 0.0) ? -vel.x : vel.x);
+                vel.y = ((pos.y < 0.0 && vel.y < 0.0) || (pos.y > BOUNDS && vel.y > 0.0) ? -vel.y : vel.y);
+            }
+        }
+    );
+
+    return scheduler;
+}
+
+auto same_state(Sim& sim1, Sim& sim2) -> bool
+{
+    auto& comps1{ sim1.components };
+    auto& comps2{ sim2.components };
+    for (size_t id{ 0 }; id < ENTITY_COUNT; id++)
+    {
+        const auto pos1{ comps1.get<se::Pos>(id) };
+        const auto pos2{ comps2.get<se::Pos>(id) };
+        const auto vel1{ comps1.get<se::Vel>(id) };
+        const auto vel2{ comps2.get<se::Vel>(id) };
+        if (pos1.x != pos2.x
+            || pos1.y != pos2.y
+            || vel1.x != vel2.x
+            || vel1.y != vel2.y
+            || comps1.get<Invuln>(id).remaining != comps2.get<Invuln>(id).remaining
+            || comps1.get<Flipped>(id).flipped != comps2.get<Flipped>(id).flipped
+            || comps1.contains<Lifespan>(id) != comps2.contains<Lifespan>(id)
+            || (comps1.contains<Lifespan>(id)
+                && comps1.get<Lifespan>(id).remaining != comps2.get<Lifespan>(id).remaining))
+        {
+            return false;
+        }
+    }
+
+    return sim1.expired == sim2.expired;
+}
+} // namespace
@@ -0,0 +1,149 @@
+#include "bench.hpp"
+#include "se-components.hpp"
+#include "se-simd.hpp"
+#include "sl-log.hpp"
+
+#include <array>
+#include <cstddef>
+#include <format>
+
+namespace se = seb_engine;
+namespace simd = seb_engine::simd;
+namespace slog = seblib::log;
+
+namespace
+{
+inline constexpr std::array ENTITY_COUNTS{ 10000UZ, 100000UZ };
+inline constexpr std::array LEVELS{ simd::Level::Scalar, simd::Level::Sse, simd::Level::Avx2 };
+inline constexpr size_t ENTITY_TICKS{ 20000000 };
+inline constexpr float DT{ 1.0 / 60.0 };
+// the integrated values are checked after this many ticks
+inline constexpr size_t CHECK_TICKS{ 100 };
+
+using BenchComponents = se::Components<se::Pos, se::Vel>;
+
+auto init(BenchComponents& components, size_t entity_count) -> void;
+auto move_view(BenchComponents& components) -> void;
+auto move_simd(BenchComponents& components, simd::Level level) -> void;
+auto report_move(std::string_view name, size_t entity_count, size_t ticks, double ns) -> void;
+auto levels_match(size_t entity_count) -> bool;
+} // namespace
+
+namespace bench
+{
+// compares the view based move Game used before, with the page kernels at each instruction set the cpu supports
+auto simd() -> bool
+{
+    slog::log(slog::INF, "Detected SIMD level: {}", simd::level_name(simd::detected_level()));
+    auto matches{ true };
+    for (const auto entity_count : ENTITY_COUNTS)
+    {
+        const auto ticks{ ENTITY_TICKS / entity_count };
+        BenchComponents components;
+        init(components, entity_count);
+        const auto view_ns{ bench::mean_ns(ticks, [&components]() { move_view(components); }) };
+        report_move("view", entity_count, ticks, view_ns);
+        for (const auto level : LEVELS)
+        {
+            if (level > simd::detected_level())
+            {
+                continue;
+            }
+
+            const auto ns{ bench::mean_ns(ticks, [&components, level]() { move_simd(components, level); }) };
+            report_move(simd::level_name(level), entity_count, ticks, ns);
+        }
+
+        matches = levels_match(entity_count) && matches;
+    }
+
+    return matches;
+}
+} // namespace bench
+
+namespace
+{
+// every other entity moves, as in Game most entities are stationary or children
+auto init(BenchComponents& components, const size_t entity_count) -> void
+{
+    components.resize(entity_count);
+    for (size_t id{ 0 }; id < entity_count; id++)
+    {
+        components.add<se::Pos>(id) = se::Pos{ static_cast<float>(id), 0.0 };
+        components.add<se::Vel>(id) = (id % 2 == 0 ? se::Vel{ 1.0, -2.0 } : se::Vel{});
+    }
+}
+
+auto move_view(BenchComponents& components) -> void
+{
+    for (const auto [id, pos, vel] : components.view<se::Pos, se::Vel>())
+    {
+        if (vel.x == 0.0 && vel.y == 0.0)
+        {
+            continue;
+        }
+
+        pos += vel * DT;
+    }
+}
+
+auto move_simd(BenchComponents& components, const simd::Level level) -> void
+{
+    auto& pos{ components.vec<se::Pos>() };
+    auto const& vel{ components.vec<se::Vel>() };
+    for (size_t page{ 0 }; page < pos.page_count(); page++)
+    {
+        simd::integrate(pos.page(page), vel.page(page), DT, level);
+    }
+}
+
+auto report_move(const std::string_view name, const size_t entity_count, const size_t ticks, const double ns) -> void
+{
+    bench::report(
+        std::format(
+            "Move {} entities ({}, {:.0f} entities/ms)",
+            entity_count,
+            name,
+            static_cast<double>(entity_count) * 1.0e6 / ns
+        ),
+        ticks,
+        ns
+    );
+}
+
+// every level has to give bit identical results to the view based move, or replays would diverge between machines
+auto levels_match(const size_t entity_count) -> bool
+{
+    BenchComponents expected;
+    init(expected, entity_count);
+    for (size_t i{ 0 }; i < CHECK_TICKS; i++)
+    {
+        move_view(expected);
+    }
+
+    auto matches{ true };
+    for (const auto level : LEVELS)
+    {
+        BenchComponents components;
+        init(components, entity_count);
+        for (size_t i{ 0 }; i < CHECK_TICKS; i++)
+        {
+            move_simd(components, level);
+        }
+
+        for (size_t id{ 0 }; id < entity_count; id++)
+        {
+            const auto pos{ components.get<se::Pos>(id) };
+            const auto expected_pos{ expected.get<se::Pos>(id) };
+            if (pos.x != expected_pos.x || pos.y != expected_pos.y)
+            {
+                slog::log(slog::ERR, "{} move differs from view based move", simd::level_name(level));
+                matches = false;
+                break;
+            }
+        }
+    }
+
+    return matches;
+}
+} // namespace
@@ -0,0 +1,282 @@
+#include "bench.hpp"
+#include "se-components.hpp"
+#include "se-entities.hpp"
+#include "se-hierarchy.hpp"
+#include "se-snapshot.hpp"
+#include "sl-log.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace se = seb_engine;
+namespace slog = seblib::log;
+
+namespace
+{
+enum class BenchEntity : uint8_t
+{
+    None = 0,
+
+    Thing,
+    Child,
+};
+
+inline constexpr size_t ENTITY_COUNT{ 100000 };
+inline constexpr size_t MAX_ENTITIES{ 131072 };
+inline constexpr size_t ITERATIONS{ 20 };
+inline constexpr uint32_t VERSION{ 1 };
+// every this many entities is a child of the one before it
+inline constexpr size_t CHILD_STRIDE{ 4 };
+inline constexpr size_t DESTROY_STRIDE{ 7 };
+
+struct Health
+{
+    int current{ 0 };
+    int max{ 0 };
+};
+
+using BenchComponents = se::Components<se::Pos, se::Vel, Health>;
+
+struct BenchWorld
+{
+    se::Entities<BenchEntity> entities{ MAX_ENTITIES };
+    BenchComponents components;
+    se::Hierarchy hierarchy;
+
+    BenchWorld();
+};
+
+auto build(BenchWorld& world) -> void;
+auto save(BenchWorld const& world, std::filesystem::path const& path) -> bool;
+auto load(BenchWorld& world, std::filesystem::path const& path) -> bool;
+auto worlds_match(BenchWorld& expected, BenchWorld& loaded) -> bool;
+auto rejects_inconsistent(std::filesystem::path const& path) -> bool;
+} // namespace
+
+namespace bench
+{
+// compares loading a snapshot with building the same entities by spawning them
+auto snapshot() -> bool
+{
+    const auto path{ std::filesystem::temp_directory_path() / "seb-bench.snap" };
+    BenchWorld expected;
+    build(expected);
+    auto saved{ save(expected, path) };
+
+    const auto build_ns{ bench::mean_ns(
+        ITERATIONS,
+        []()
+        {
+            BenchWorld world;
+            build(world);
+        }
+    ) };
+    const auto save_ns{ bench::mean_ns(ITERATIONS, [&]() { saved = save(expected, path) && saved; }) };
+    auto loaded{ true };
+    const auto load_ns{ bench::mean_ns(
+        ITERATIONS,
+        [&]()
+        {
+            BenchWorld world;
+            loaded = load(world, path) && loaded;
+        }
+    ) };
+    bench::report(std::format("Build {} entities by spawning", ENTITY_COUNT), ITERATIONS, build_ns);
+    bench::report(std::format("Save {} entities", ENTITY_COUNT), ITERATIONS, save_ns);
+    bench::report(std::format("Load {} entities", ENTITY_COUNT), ITERATIONS, load_ns);
+
+    BenchWorld world;
+    const auto matches{ saved && loaded && load(world, path) && worlds_match(expected, world) };
+    const auto rejected{ rejects_inconsistent(path) };
+    std::filesystem::remove(path);
+    if (!matches)
+    {
+        slog::log(slog::ERR, "Loaded snapshot differs from the saved entities");
+    }
+
+    if (!rejected)
+    {
+        slog::log(slog::ERR, "Inconsistent snapshot was loaded or changed the world");
+    }
+
+    return matches && rejected;
+}
+} // namespace bench
+
+namespace
+{
+BenchWorld::BenchWorld()
+{
+    components.reg<Health>(se::Storage::Sparse);
+}
+
+// some entities are destroyed after spawning, so the snapshot carries a free list and bumped generations
+auto build(BenchWorld& world) -> void
+{
+    const auto ids{ world.entities.spawn_batch(BenchEntity::Thing, ENTITY_COUNT) };
+    const auto capacity{ world.entities.capacity() };
+    world.components.resize(capacity);
+    world.hierarchy.resize(capacity);
+    for (const auto id : ids)
+    {
+        world.components.add<se::Pos>(id) = se::Pos{ static_cast<float>(id), 0.0 };
+        world.components.add<se::Vel>(id) = se::Vel{ 1.0, -1.0 };
+        if (id % 2 == 0)
+        {
+            world.components.add<Health>(id) = Health{ .current = static_cast<int>(id), .max = 100 }; // NOLINT
+        }
+
+        if (id % CHILD_STRIDE != 0)
+        {
+            world.hierarchy.attach(id, id - 1);
+        }
+    }
+
+    for (size_t id{ 0 }; id < ENTITY_COUNT; id += DESTROY_STRIDE * CHILD_STRIDE)
+    {
+        world.hierarchy.destroy(
+            id,
+            [&world](const size_t destroyed_id)
+            {
+                world.entities.destroy(destroyed_id);
+                world.components.uninit(destroyed_id);
+            }
+        );
+    }
+}
+
+auto save(BenchWorld const& world, std::filesystem::path const& path) -> bool
+{
+    se::snapshot::Writer writer{ VERSION };
+    world.entities.save(writer);
+    world.components.save(writer);
+    world.hierarchy.save(writer);
+
+    return writer.save(path);
+}
+
+auto load(BenchWorld& world, std::filesystem::path const& path) -> bool
+{
+    se::snapshot::Reader reader{ path, VERSION };
+    const auto entity_sections{ world.entities.read(reader) };
+    const auto component_sections{ world.components.read(reader, entity_sections.entities) };
+    const auto hierarchy_sections{ world.hierarchy.read(reader, entity_sections.entities) };
+    if (!reader.ok())
+    {
+        return false;
+    }
+
+    world.entities.load(entity_sections);
+    world.components.load(component_sections);
+    world.hierarchy.load(hierarchy_sections);
+
+    return true;
+}
+
+auto worlds_match(BenchWorld& expected, BenchWorld& loaded) -> bool
+{
+    if (expected.entities.capacity() != loaded.entities.capacity()
+        || expected.entities.ids(BenchEntity::Thing) != loaded.entities.ids(BenchEntity::Thing))
+    {
+        return false;
+    }
+
+    for (size_t id{ 0 }; id < expected.entities.capacity(); id++)
+    {
+        const auto expected_pos{ expected.components.vec<se::Pos>()[id] };
+        const auto pos{ loaded.components.vec<se::Pos>()[id] };
+        const auto has_health{ expected.components.contains<Health>(id) };
+        if (expected.entities.handle(id) != loaded.entities.handle(id)
+            || expected_pos.x != pos.x
+            || expected_pos.y != pos.y
+            || has_health != loaded.components.contains<Health>(id)
+            || (has_health && expected.components.get<Health>(id).current != loaded.components.get<Health>(id).current)
+            || expected.hierarchy.parent(id) != loaded.hierarchy.parent(id))
+        {
+            return false;
+        }
+    }
+
+    // spawning after loading has to hand out the same ids as the saved table would
+    return expected.entities.spawn(BenchEntity::Child) == loaded.entities.spawn(BenchEntity::Child);
+}
+
+// each snapshot is made of well formed sections which don't agree with each other, so loading has to fail without
+// changing the world it was loaded into
+auto rejects_inconsistent(std::filesystem::path const& path) -> bool
+{
+    BenchWorld world;
+    build(world);
+    const auto capacity{ world.entities.capacity() };
+    const auto thing_ids{ world.entities.ids(BenchEntity::Thing) };
+    const auto unchanged{ [&]()
+                          {
+                              return world.entities.capacity() == capacity
+                                  && world.entities.ids(BenchEntity::Thing) == thing_ids
+                                  && world.components.vec<se::Pos>()[thing_ids.back()].x
+                                  == static_cast<float>(thing_ids.back());
+                          } };
+
+    // id 0 is both free and live
+    se::snapshot::Writer overlapping{ VERSION };
+    const std::array types{ BenchEntity::Thing };
+    const std::array<uint32_t, 1> generations{};
+    const std::array<size_t, 1> id_zero{};
+    // one count for every value of the entity type's underlying byte
+    std::array<size_t, 256> counts{}; // NOLINT(*magic-numbers)
+    counts[std::to_underlying(BenchEntity::Thing)] = 1;
+    overlapping.write(std::span<const BenchEntity>{ types });
+    overlapping.write(std::span<const uint32_t>{ generations });
+    overlapping.write(std::span<const size_t>{ id_zero });
+    overlapping.write(std::span<const size_t>{ id_zero });
+    overlapping.write(std::span<const size_t>{ counts });
+    overlapping.write(std::span<const size_t>{ id_zero });
+    const auto overlapping_rejected{ overlapping.save(path) && !load(world, path) && unchanged() };
+
+    // a valid entity table followed by components saved for no entities
+    se::snapshot::Writer mismatched{ VERSION };
+    const BenchWorld empty;
+    world.entities.save(mismatched);
+    empty.components.save(mismatched);
+    empty.hierarchy.save(mismatched);
+    const auto mismatched_rejected{ mismatched.save(path) && !load(world, path) && unchanged() };
+
+    // the rest are built as normal, then broken through calls which leave the storages disagreeing
+    // the first few entities were destroyed, the ones from CHILD_STRIDE on are a parent with a chain of children
+    const auto broken_rejected{ [&](auto&& breaks)
+                                {
+                                    BenchWorld broken;
+                                    build(broken);
+                                    breaks(broken);
+
+                                    return save(broken, path) && !load(world, path) && unchanged();
+                                } };
+    const auto parent_loop_rejected{ broken_rejected(
+        [](BenchWorld& broken) { broken.hierarchy.attach(CHILD_STRIDE, CHILD_STRIDE + 2); }
+    ) };
+    // a parent destroyed without its hierarchy is still linked to its children
+    const auto free_linked_rejected{ broken_rejected(
+        [](BenchWorld& broken)
+        {
+            broken.entities.destroy(CHILD_STRIDE);
+            broken.components.uninit(CHILD_STRIDE);
+        }
+    ) };
+    const auto free_components_rejected{ broken_rejected(
+        [](BenchWorld& broken)
+        {
+            broken.hierarchy.detach(CHILD_STRIDE + 3);
+            broken.entities.destroy(CHILD_STRIDE + 3);
+        }
+    ) };
+
+    return overlapping_rejected && mismatched_rejected && parent_loop_rejected && free_linked_rejected
+        && free_components_rejected;
+}
+} // namespace
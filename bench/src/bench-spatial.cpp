@@ -0,0 +1,155 @@
+#include "bench.hpp"
+#include "se-bbox.hpp"
+#include "se-spatial.hpp"
+#include "sl-log.hpp"
+#include "sl-math.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace se = seb_engine;
+namespace sm = seblib::math;
+namespace rl = raylib;
+namespace slog = seblib::log;
+
+namespace
+{
+inline constexpr std::array ENEMY_COUNTS{ 250UZ, 1000UZ, 4000UZ };
+// about a sector attack's worth of damage lines, plus a few projectiles
+inline constexpr size_t LINE_COUNT{ 64 };
+inline constexpr size_t PROJECTILE_COUNT{ 16 };
+inline constexpr size_t SAMPLES{ 50 };
+inline constexpr size_t BATCH_SIZE{ 10 };
+inline constexpr unsigned SEED{ 1234 };
+// matching Game's enemy hitboxes, damage lines and cells
+inline constexpr sm::Vec2 ENEMY_SIZE{ 22.0, 16.0 };
+inline constexpr float LINE_LEN{ 50.0 };
+inline constexpr float PROJECTILE_RADIUS{ 4.0 };
+inline constexpr float CELL_SIZE{ 32.0 };
+// enemies are packed about as tightly as they bunch up in game, so the area grows with their count
+inline constexpr float SPACING_PER_ENEMY{ 24.0 };
+
+struct Scene
+{
+    std::vector<se::BBoxVariant> enemies;
+    std::vector<se::BBoxVariant> attacks;
+
+    explicit Scene(size_t enemy_count);
+};
+
+using Hits = std::vector<std::pair<size_t, size_t>>;
+
+auto brute_force(Scene const& scene, Hits& hits) -> void;
+auto spatial_hash(Scene const& scene, se::SpatialHash& hash, std::vector<size_t>& candidates, Hits& hits) -> void;
+} // namespace
+
+namespace bench
+{
+// damage_entities' hit detection, checking every attack against every enemy and against only the enemies sharing a
+// cell with it, where both must find the same hits
+auto spatial() -> bool
+{
+    auto matches{ true };
+    for (const auto enemy_count : ENEMY_COUNTS)
+    {
+        const Scene scene{ enemy_count };
+        Hits brute_hits;
+        Hits hash_hits;
+        se::SpatialHash hash{ CELL_SIZE };
+        std::vector<size_t> candidates;
+        const auto brute_stats{ bench::sample_ns(SAMPLES, BATCH_SIZE, [&]() { brute_force(scene, brute_hits); }) };
+        bench::report(std::format("Hit detection (brute force, {} enemies)", enemy_count), brute_stats);
+        const auto hash_stats{
+            bench::sample_ns(SAMPLES, BATCH_SIZE, [&]() { spatial_hash(scene, hash, candidates, hash_hits); })
+        };
+        bench::report(std::format("Hit detection (spatial hash, {} enemies)", enemy_count), hash_stats);
+        if (brute_hits != hash_hits)
+        {
+            slog::log(
+                slog::ERR,
+                "Spatial hash found {} hits against {} enemies, brute force found {}",
+                hash_hits.size(),
+                enemy_count,
+                brute_hits.size()
+            );
+            matches = false;
+        }
+    }
+
+    return matches;
+}
+} // namespace bench
+
+namespace
+{
+Scene::Scene(const size_t enemy_count)
+{
+    const auto area_len{ std::sqrt(static_cast<float>(enemy_count)) * SPACING_PER_ENEMY };
+    std::mt19937 rng{ SEED };
+    std::uniform_real_distribution<float> coord{ 0.0, area_len };
+    std::uniform_real_distribution<float> angle{ 0.0, 360.0 }; // NOLINT(*magic-numbers)
+    for (size_t i{ 0 }; i < enemy_count; i++)
+    {
+        enemies.emplace_back(rl::Rectangle{ coord(rng), coord(rng), ENEMY_SIZE.x, ENEMY_SIZE.y });
+    }
+
+    for (size_t i{ 0 }; i < LINE_COUNT; i++)
+    {
+        attacks.emplace_back(sm::Line{ sm::Vec2{ coord(rng), coord(rng) }, LINE_LEN, angle(rng) });
+    }
+
+    for (size_t i{ 0 }; i < PROJECTILE_COUNT; i++)
+    {
+        attacks.emplace_back(sm::Circle{ sm::Vec2{ coord(rng), coord(rng) }, PROJECTILE_RADIUS });
+    }
+}
+
+auto brute_force(Scene const& scene, Hits& hits) -> void
+{
+    hits.clear();
+    for (size_t attack{ 0 }; attack < scene.attacks.size(); attack++)
+    {
+        for (size_t enemy{ 0 }; enemy < scene.enemies.size(); enemy++)
+        {
+            if (se::bbox::collides(scene.enemies[enemy], scene.attacks[attack]))
+            {
+                hits.emplace_back(attack, enemy);
+            }
+        }
+    }
+}
+
+// rebuilt every call, as Game does every tick
+auto spatial_hash(Scene const& scene, se::SpatialHash& hash, std::vector<size_t>& candidates, Hits& hits) -> void
+{
+    hits.clear();
+    hash.clear();
+    for (size_t enemy{ 0 }; enemy < scene.enemies.size(); enemy++)
+    {
+        hash.insert(enemy, se::bbox::bounds(scene.enemies[enemy]));
+    }
+
+    hash.build();
+    for (size_t attack{ 0 }; attack < scene.attacks.size(); attack++)
+    {
+        candidates.clear();
+        hash.query(
+            se::bbox::bounds(scene.attacks[attack]), [&candidates](const size_t enemy) { candidates.push_back(enemy); }
+        );
+        std::ranges::sort(candidates);
+        for (const auto enemy : candidates)
+        {
+            if (se::bbox::collides(scene.enemies[enemy], scene.attacks[attack]))
+            {
+                hits.emplace_back(attack, enemy);
+            }
+        }
+    }
+}
+} // namespace
@@ -0,0 +1,347 @@
+#include "bench.hpp"
+#include "se-bbox.hpp"
+#include "se-snapshot.hpp"
+#include "se-sprite.hpp"
+#include "se-tiles.hpp"
+#include "sl-log.hpp"
+#include "sl-math.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace se = seb_engine;
+namespace sm = seblib::math;
+namespace rl = raylib;
+namespace slog = seblib::log;
+
+namespace
+{
+enum class BenchTile : uint8_t
+{
+    None = 0,
+
+    Block,
+};
+
+enum class BenchSprite : uint8_t
+{
+    None = 0,
+
+    Idle,
+    Walk,
+};
+
+inline constexpr unsigned TILE_LEN{ 16 };
+inline constexpr size_t CBOX_SAMPLES{ 50 };
+inline constexpr size_t SPRITE_COUNT{ 4096 };
+inline constexpr size_t SPRITE_SAMPLES{ 200 };
+inline constexpr size_t SPRITE_BATCH_SIZE{ 10000 };
+inline constexpr unsigned SEED{ 1234 };
+inline constexpr size_t COLLISION_WORLD_LEN{ 256 };
+inline constexpr size_t COLLISION_ENTITIES{ 2000 };
+inline constexpr size_t COLLISION_SAMPLES{ 20 };
+// matching Game's enemy bbox
+inline constexpr sm::Vec2 ENTITY_SIZE{ 22.0, 16.0 };
+
+using BenchSprites = se::Sprites<BenchSprite>;
+template <size_t Width, size_t Height>
+using BenchWorld = se::World<BenchTile, BenchSprite, Width, Height, TILE_LEN>;
+
+template <size_t Width, size_t Height>
+auto level() -> std::vector<BenchTile>;
+template <size_t Width, size_t Height>
+auto calculate_cboxes() -> bool;
+auto tile_collisions() -> bool;
+auto sprites_set() -> void;
+auto snapshot_tiles() -> bool;
+} // namespace
+
+template <>
+auto se::TileDetailsLookup<BenchTile, BenchSprite>::get(const BenchTile tile) -> se::TileDetails<BenchSprite>
+{
+    switch (tile)
+    {
+    case BenchTile::None:
+        return { .type = TileType::Empty, .sprite = BenchSprite::None };
+    case BenchTile::Block:
+        return { .type = TileType::Block, .sprite = BenchSprite::Idle };
+    }
+
+    std::unreachable();
+}
+
+template <>
+auto se::TileDetailsLookup<BenchTile, BenchSprite>::valid(const BenchTile tile) -> bool
+{
+    switch (tile)
+    {
+    case BenchTile::None:
+    case BenchTile::Block:
+        return true;
+    }
+
+    return false;
+}
+
+template <>
+auto se::SpriteDetailsLookup<BenchSprite>::get(const BenchSprite sprite) -> se::SpriteDetails
+{
+    switch (sprite)
+    { // NOLINTBEGIN(*magic-numbers)
+    case BenchSprite::None:
+        return {};
+    case BenchSprite::Idle:
+        return { .pos = { 0.0, 0.0 }, .size = { 32.0, 32.0 } };
+    case BenchSprite::Walk:
+        return { .pos = { 32.0, 0.0 }, .size = { 32.0, 32.0 }, .frames = 4, .frame_duration = 0.1 };
+    } // NOLINTEND(*magic-numbers)
+
+    std::unreachable();
+}
+
+namespace bench
+{
+auto world() -> bool
+{
+    const auto small_cboxes_ok{ calculate_cboxes<32, 16>() }; // NOLINT(*magic-numbers)
+    const auto large_cboxes_ok{ calculate_cboxes<64, 32>() }; // NOLINT(*magic-numbers)
+    const auto collisions_ok{ tile_collisions() };
+    sprites_set();
+    const auto snapshot_ok{ snapshot_tiles() };
+
+    return small_cboxes_ok && large_cboxes_ok && collisions_ok && snapshot_ok;
+}
+} // namespace bench
+
+namespace
+{
+// solid edges and scattered platforms, much like a level built in Game, laid out as World stores its tiles
+// the edges run along the top row and right column, so growing a cbox has to stop at the edge of the world
+template <size_t Width, size_t Height>
+auto level() -> std::vector<BenchTile>
+{
+    std::vector<BenchTile> tiles(Width * Height, BenchTile::None);
+    const auto block{ [&tiles](const size_t x, const size_t y) { tiles[(x * Height) + y] = BenchTile::Block; } };
+    std::mt19937 rng{ SEED };
+    std::uniform_int_distribution<size_t> x_dist{ 1, Width - 5 };
+    std::uniform_int_distribution<size_t> y_dist{ 2, Height - 3 };
+    for (size_t x{ 0 }; x < Width; x++)
+    {
+        block(x, 0);
+        block(x, Height - 1);
+    }
+
+    for (size_t y{ 1 }; y < Height - 1; y++)
+    {
+        block(0, y);
+        block(Width - 1, y);
+    }
+
+    for (size_t i{ 0 }; i < Width * Height / 32; i++) // NOLINT(*magic-numbers)
+    {
+        const auto x{ x_dist(rng) };
+        const auto y{ y_dist(rng) };
+        for (size_t dx{ 0 }; dx < 3; dx++)
+        {
+            block(x + dx, y);
+        }
+    }
+
+    return tiles;
+}
+
+// the cboxes have to stay inside the world, and cover every block and nothing else
+template <size_t Width, size_t Height>
+auto calculate_cboxes() -> bool
+{
+    BenchWorld<Width, Height> world;
+    world.set_tiles(level<Width, Height>());
+    const auto stats{ bench::sample_ns(CBOX_SAMPLES, 1, [&world]() { world.calculate_cboxes(); }) };
+    bench::report(
+        std::format("World::calculate_cboxes {}x{} ({} cboxes)", Width, Height, world.cboxes().size()), stats
+    );
+
+    const auto& cboxes{ world.cboxes() };
+    const auto inside{ std::ranges::all_of(
+        cboxes,
+        [](const rl::Rectangle cbox)
+        {
+            return cbox.x >= 0.0 && cbox.x + cbox.width <= Width * TILE_LEN && cbox.y >= -(Height - 1.0F) * TILE_LEN
+                && cbox.y + cbox.height <= TILE_LEN;
+        }
+    ) };
+    auto covered{ true };
+    for (size_t x{ 0 }; x < Width; x++)
+    {
+        for (size_t y{ 0 }; y < Height; y++)
+        {
+            const rl::Vector2 centre{ (static_cast<float>(x) + 0.5F) * TILE_LEN,
+                                      (0.5F - static_cast<float>(y)) * TILE_LEN };
+            const auto in_cbox{ std::ranges::any_of(
+                cboxes, [centre](const rl::Rectangle cbox) { return cbox.CheckCollision(centre); }
+            ) };
+            covered = covered && in_cbox == (world.at(se::Coords<TILE_LEN>{ x, y }) == BenchTile::Block);
+        }
+    }
+
+    if (!inside || !covered)
+    {
+        slog::log(slog::ERR, "World::calculate_cboxes {}x{} doesn't cover exactly the blocks", Width, Height);
+    }
+
+    return inside && covered;
+}
+
+// resolve_tile_collisions on a large world, checking each entity against every cbox and against only the cboxes on
+// the tiles under it, where both must leave the entities in the same place
+// entities are scattered over the whole world, so plenty of them start out inside a platform
+auto tile_collisions() -> bool
+{
+    BenchWorld<COLLISION_WORLD_LEN, COLLISION_WORLD_LEN> world;
+    world.set_tiles(level<COLLISION_WORLD_LEN, COLLISION_WORLD_LEN>());
+    auto const& cboxes{ world.cboxes() };
+    const se::BBox bbox{ se::BBoxRect{ ENTITY_SIZE } };
+    std::mt19937 rng{ SEED };
+    const auto world_len{ static_cast<float>(COLLISION_WORLD_LEN * TILE_LEN) };
+    std::uniform_real_distribution<float> x_dist{ 0.0, world_len };
+    std::uniform_real_distribution<float> y_dist{ -world_len, 0.0 };
+    std::vector<sm::Vec2> start(COLLISION_ENTITIES);
+    std::ranges::generate(start, [&]() { return sm::Vec2{ x_dist(rng), y_dist(rng) }; });
+    auto brute_positions{ start };
+    auto grid_positions{ start };
+    std::vector<size_t> near_cboxes;
+    const auto brute_stats{ bench::sample_ns(
+        COLLISION_SAMPLES,
+        1,
+        [&]()
+        {
+            std::ranges::copy(start, brute_positions.begin());
+            for (auto& pos : brute_positions)
+            {
+                for (const auto tile_cbox : cboxes)
+                {
+                    const auto cbox{ bbox.val(pos) };
+                    if (se::bbox::collides(cbox, tile_cbox))
+                    {
+                        pos += se::bbox::resolve_collision(cbox, tile_cbox);
+                    }
+                }
+            }
+        }
+    ) };
+    const auto name{ std::format(
+        "{}x{}, {} cboxes, {} entities", COLLISION_WORLD_LEN, COLLISION_WORLD_LEN, cboxes.size(), COLLISION_ENTITIES
+    ) };
+    bench::report(std::format("Tile collisions (every cbox, {})", name), brute_stats);
+    const auto grid_stats{ bench::sample_ns(
+        COLLISION_SAMPLES,
+        1,
+        [&]()
+        {
+            std::ranges::copy(start, grid_positions.begin());
+            for (auto& pos : grid_positions)
+            {
+                auto cbox{ bbox.val(pos) };
+                world.cboxes_in(se::bbox::bounds(cbox), near_cboxes);
+                size_t i{ 0 };
+                while (i < near_cboxes.size())
+                {
+                    const auto cbox_id{ near_cboxes[i] };
+                    i++;
+                    if (se::bbox::collides(cbox, cboxes[cbox_id]))
+                    {
+                        pos += se::bbox::resolve_collision(cbox, cboxes[cbox_id]);
+                        cbox = bbox.val(pos);
+                        world.cboxes_in(se::bbox::bounds(cbox), near_cboxes);
+                        i = static_cast<size_t>(std::ranges::upper_bound(near_cboxes, cbox_id) - near_cboxes.begin());
+                    }
+                }
+            }
+        }
+    ) };
+    bench::report(std::format("Tile collisions (cboxes by tile, {})", name), grid_stats);
+    const auto same{ std::ranges::equal(
+        brute_positions,
+        grid_positions,
+        [](const auto pos1, const auto pos2) { return pos1.x == pos2.x && pos1.y == pos2.y; }
+    ) };
+    if (!same)
+    {
+        slog::log(slog::ERR, "Tile collisions by tile left entities in different places to checking every cbox");
+        return false;
+    }
+
+    return true;
+}
+
+// ids are picked at random up front, and the sprite alternates so most calls change it rather than returning early
+auto sprites_set() -> void
+{
+    BenchSprites sprites;
+    sprites.resize(SPRITE_COUNT);
+    std::mt19937 rng{ SEED };
+    std::uniform_int_distribution<unsigned> id_dist{ 0, SPRITE_COUNT - 1 };
+    std::vector<unsigned> ids(SPRITE_COUNT);
+    std::ranges::generate(ids, [&]() { return id_dist(rng); });
+    size_t i{ 0 };
+    auto walk{ false };
+    const auto stats{ bench::sample_ns(
+        SPRITE_SAMPLES,
+        SPRITE_BATCH_SIZE,
+        [&]()
+        {
+            i = (i + 1) % SPRITE_COUNT;
+            walk = !walk;
+            sprites.set(ids[i], walk ? BenchSprite::Walk : BenchSprite::Idle);
+        }
+    ) };
+    bench::report(std::format("Sprites::set ({} sprites)", SPRITE_COUNT), stats);
+}
+
+// a level has to load back as it was saved, while a tile which isn't a BenchTile has to be rejected before the world
+// is touched
+auto snapshot_tiles() -> bool
+{
+    constexpr size_t width{ 32 };
+    constexpr size_t height{ 16 };
+    constexpr uint32_t version{ 1 };
+    const auto path{ std::filesystem::temp_directory_path() / "seb-bench-world.snap" };
+    const auto load{ [&path](BenchWorld<width, height>& world)
+                     {
+                         se::snapshot::Reader reader{ path, version };
+                         const auto sections{ world.read(reader) };
+                         if (reader.ok())
+                         {
+                             world.load(sections);
+                         }
+
+                         return reader.ok();
+                     } };
+    BenchWorld<width, height> saved;
+    saved.set_tiles(level<width, height>());
+    se::snapshot::Writer writer{ version };
+    saved.save(writer);
+    BenchWorld<width, height> loaded;
+    const auto round_trip{ writer.save(path) && load(loaded) && loaded.tiles() == saved.tiles() };
+
+    auto unknown_tiles{ saved.tiles() };
+    unknown_tiles.back() = static_cast<BenchTile>(std::to_underlying(BenchTile::Block) + 1);
+    se::snapshot::Writer unknown_writer{ version };
+    unknown_writer.write(std::span<const BenchTile>{ unknown_tiles });
+    const auto rejected{ unknown_writer.save(path) && !load(loaded) && loaded.tiles() == saved.tiles() };
+    std::filesystem::remove(path);
+    if (!round_trip || !rejected)
+    {
+        slog::log(slog::ERR, "World snapshot didn't round trip, or loaded a tile which doesn't exist");
+    }
+
+    return round_trip && rejected;
+}
+} // namespace
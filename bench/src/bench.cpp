@@ -0,0 +1,103 @@
+#include "bench.hpp"
+
+#include "sl-log.hpp"
+#include "sl-stats.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace slog = seblib::log;
+namespace ss = seblib::stats;
+
+namespace
+{
+struct Result
+{
+    std::string name;
+    bench::Stats stats;
+    // only set for benchmarks which were sampled
+    bool sampled{ false };
+};
+
+std::vector<Result> results; // NOLINT(*non-const-global-variables)
+} // namespace
+
+namespace bench
+{
+auto stats(std::vector<double> samples, const size_t batch_size) -> Stats
+{
+    const auto count{ samples.size() };
+    const auto summary{ ss::summarise(std::move(samples)) };
+
+    return {
+        .iterations = count * batch_size,
+        .mean_ns = summary.mean,
+        .median_ns = summary.median,
+        .p99_ns = summary.p99,
+    };
+}
+
+auto report(const std::string_view name, const size_t iterations, const double mean_ns) -> void
+{
+    std::cout << std::format(
+        "{:<50} {:>10} iterations {:>10.1f} ns/op {:>14.0f} ops/s\n", name, iterations, mean_ns, 1.0e9 / mean_ns
+    );
+    results.push_back({ .name = std::string{ name }, .stats = { .iterations = iterations, .mean_ns = mean_ns } });
+}
+
+auto report(const std::string_view name, Stats const& stats) -> void
+{
+    std::cout << std::format(
+        "{:<50} {:>10} iterations {:>10.1f} ns/op {:>14.0f} ops/s {:>10.1f} ns median {:>10.1f} ns p99\n",
+        name,
+        stats.iterations,
+        stats.mean_ns,
+        1.0e9 / stats.mean_ns,
+        stats.median_ns,
+        stats.p99_ns
+    );
+    results.push_back({ .name = std::string{ name }, .stats = stats, .sampled = true });
+}
+
+auto write_json(std::filesystem::path const& path) -> bool
+{
+    std::ofstream file{ path };
+    file << "{\n  \"benchmarks\": [";
+    for (size_t i{ 0 }; i < results.size(); i++)
+    {
+        const auto& [name, stats, sampled]{ results[i] };
+        file << (i == 0 ? "\n" : ",\n");
+        file << std::format(
+            R"(    {{ "name": {}, "iterations": {}, "mean_ns": {:.3f})",
+            ss::json_string(name),
+            stats.iterations,
+            stats.mean_ns
+        );
+        if (sampled)
+        {
+            file << std::format(R"(, "median_ns": {:.3f}, "p99_ns": {:.3f})", stats.median_ns, stats.p99_ns);
+        }
+
+        file << " }";
+    }
+
+    file << "\n  ]\n}\n";
+    if (!file)
+    {
+        slog::log(slog::ERR, "Failed to write benchmark results to {}", path.string());
+
+        return false;
+    }
+
+    slog::log(slog::INF, "Wrote {} benchmark results to {}", results.size(), path.string());
+
+    return true;
+}
+} // namespace bench
@@ -0,0 +1,34 @@
+#include "bench.hpp"
+#include "sl-log.hpp"
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace slog = seblib::log;
+
+// pass --json <file> to also write the results as json, for comparing runs
+auto main(int argc, char* argv[]) -> int
+{
+    const std::span args{ argv, static_cast<size_t>(argc) };
+    const auto json{ args.size() > 2 && std::string_view{ args[1] } == "--json" };
+    if (args.size() > 1 && !json)
+    {
+        slog::log(slog::FTL, "Usage: bench [--json <file>]");
+    }
+
+    bench::collision();
+    const auto world_ok{ bench::world() };
+    const auto entities_ok{ bench::entities() };
+    bench::archetypes();
+    const auto jobs_ok{ bench::jobs() };
+    const auto scheduler_ok{ bench::scheduler() };
+    const auto simd_ok{ bench::simd() };
+    const auto snapshot_ok{ bench::snapshot() };
+    const auto spatial_ok{ bench::spatial() };
+    const auto json_ok{ !json || bench::write_json(args[2]) };
+
+    const auto checks_ok{ world_ok && entities_ok && jobs_ok && scheduler_ok && simd_ok && snapshot_ok && spatial_ok };
+
+    return checks_ok && json_ok ? 0 : 1;
+}
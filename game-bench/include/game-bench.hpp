@@ -0,0 +1,52 @@
+#ifndef GAME_BENCH_HPP_
+#define GAME_BENCH_HPP_
+
+#include "game.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace game_bench
+{
+// a load put on the game, scaled by how many enemies it runs with
+struct Scenario
+{
+    std::string_view name;
+    // called untimed before every tick, to hold the load steady
+    std::function<void(Game&, size_t enemy_count)> prepare;
+    // called before every tick, timed as part of it, for work the player would do during the tick
+    std::function<void(Game&, size_t tick)> act;
+};
+
+// times in milliseconds
+struct Distribution
+{
+    double median_ms{ 0.0 };
+    double p99_ms{ 0.0 };
+    double max_ms{ 0.0 };
+};
+
+struct SystemResult
+{
+    std::string name;
+    Distribution time;
+};
+
+struct Result
+{
+    std::string_view scenario;
+    size_t enemy_count{ 0 };
+    Distribution tick;
+    std::vector<SystemResult> systems;
+};
+
+[[nodiscard]] auto scenarios() -> std::vector<Scenario>;
+[[nodiscard]] auto run(Scenario const& scenario, size_t enemy_count, size_t ticks) -> Result;
+[[nodiscard]] auto write_json(std::filesystem::path const& path, std::vector<Result> const& results) -> bool;
+} // namespace game_bench
+
+#endif
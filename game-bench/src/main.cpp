@@ -0,0 +1,95 @@
+#include "game-bench.hpp"
+#include "settings.hpp"
+#include "sl-log.hpp"
+
+#include <array>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace slog = seblib::log;
+namespace gb = game_bench;
+
+namespace
+{
+inline constexpr std::array ENEMY_COUNTS{ 100UZ, 250UZ, 500UZ, 1000UZ, 2000UZ, 4000UZ, 8000UZ, 16000UZ, 32000UZ };
+// five seconds of game time
+inline constexpr size_t TICKS{ 5 * TICK_RATE };
+// rendering isn't run headless, so this is the budget for a tick with nothing left over to draw the frame
+inline constexpr double FRAME_BUDGET_MS{ 1000.0 / TARGET_FPS };
+
+auto print_tick(gb::Result const& result) -> void;
+auto print_systems(gb::Result const& result) -> void;
+} // namespace
+
+// runs each scenario with more and more enemies, until the slowest ticks no longer fit in a frame
+// pass --json <file> to also write every result as json, for comparing runs
+auto main(int argc, char* argv[]) -> int
+{
+    const std::span args{ argv, static_cast<size_t>(argc) };
+    const auto json{ args.size() > 2 && std::string_view{ args[1] } == "--json" };
+    if (args.size() > 1 && !json)
+    {
+        slog::log(slog::FTL, "Usage: game-bench [--json <file>]");
+    }
+
+    std::vector<gb::Result> results;
+    for (auto const& scenario : gb::scenarios())
+    {
+        std::cout << std::format("{} ({} ticks, {:.2f}ms frame budget)\n", scenario.name, TICKS, FRAME_BUDGET_MS);
+        auto broken{ false };
+        for (const auto enemy_count : ENEMY_COUNTS)
+        {
+            auto const& result{ results.emplace_back(gb::run(scenario, enemy_count, TICKS)) };
+            print_tick(result);
+            broken = result.tick.p99_ms > FRAME_BUDGET_MS;
+            if (broken)
+            {
+                std::cout << std::format("  budget broken at {} enemies\n", enemy_count);
+                break;
+            }
+        }
+
+        if (!broken)
+        {
+            std::cout << std::format("  within budget up to {} enemies\n", ENEMY_COUNTS.back());
+        }
+
+        print_systems(results.back());
+    }
+
+    return !json || gb::write_json(args[2], results) ? 0 : 1;
+}
+
+namespace
+{
+auto print_tick(gb::Result const& result) -> void
+{
+    std::cout << std::format(
+        "  {:>6} enemies  tick {:>8.3f}ms median {:>8.3f}ms p99 {:>8.3f}ms max\n",
+        result.enemy_count,
+        result.tick.median_ms,
+        result.tick.p99_ms,
+        result.tick.max_ms
+    );
+}
+
+// systems in the same stage run at once, so their times can add up to more than the tick
+auto print_systems(gb::Result const& result) -> void
+{
+    std::cout << std::format("  systems at {} enemies\n", result.enemy_count);
+    for (auto const& [name, time] : result.systems)
+    {
+        std::cout << std::format(
+            "    {:<28} {:>8.3f}ms median {:>8.3f}ms p99 {:>8.3f}ms max\n",
+            name,
+            time.median_ms,
+            time.p99_ms,
+            time.max_ms
+        );
+    }
+}
+} // namespace
@@ -0,0 +1,229 @@
+#include "entities.hpp"
+#include "game-bench.hpp"
+#include "game.hpp"
+#include "inputs.hpp"
+#include "sl-log.hpp"
+#include "sl-math.hpp"
+#include "sl-stats.hpp"
+#include "tiles.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace slog = seblib::log;
+namespace sm = seblib::math;
+namespace ss = seblib::stats;
+
+namespace
+{
+// enemies are spread over a block of tiles in front of the player, so attacks reach a good share of them
+inline constexpr size_t ENEMY_MIN_X{ 6 };
+inline constexpr size_t ENEMY_MIN_Y{ 2 };
+inline constexpr size_t ENEMY_AREA_LEN{ 6 };
+inline constexpr Game::Coords ATTACK_TARGET{ 9, 4 };
+// tiles are edited away from the level Game builds, out to the edges of the world
+inline constexpr size_t EDIT_MIN_X{ 16 };
+inline constexpr size_t EDIT_MIN_Y{ 6 };
+inline constexpr size_t EDIT_WIDTH{ WORLD_WIDTH - EDIT_MIN_X };
+inline constexpr size_t EDIT_HEIGHT{ WORLD_HEIGHT - EDIT_MIN_Y };
+inline constexpr size_t EDITS_PER_TICK{ 4 };
+
+using Clock = std::chrono::steady_clock;
+
+auto top_up_enemies(Game& game, size_t enemy_count) -> void;
+auto edit_coords(size_t tick, size_t edit) -> Game::Coords;
+auto elapsed_ms(Clock::time_point start) -> double;
+auto distribution(std::vector<double> times_ms) -> game_bench::Distribution;
+auto write_distribution(std::ofstream& file, game_bench::Distribution const& distribution) -> void;
+} // namespace
+
+namespace game_bench
+{
+// every scenario keeps the enemy count topped up, as attacks kill enemies off
+auto scenarios() -> std::vector<Scenario>
+{
+    return {
+        Scenario{
+            .name = "ducks",
+            .prepare = top_up_enemies,
+            .act = [](Game&, size_t) {},
+        },
+        Scenario{
+            .name = "sector attacks",
+            .prepare = top_up_enemies,
+            .act =
+                [](Game& game, size_t)
+            {
+                game.inputs.mouse_world_pos = static_cast<sm::Vec2>(ATTACK_TARGET);
+                game.spawn_attack(Attack::Sector, game.player_id);
+            },
+        },
+        Scenario{
+            .name = "tile editing",
+            .prepare = top_up_enemies,
+            .act =
+                [](Game& game, const size_t tick)
+            {
+                // the tiles placed on the tick before are removed, so the area never fills up
+                for (size_t edit{ 0 }; edit < EDITS_PER_TICK; edit++)
+                {
+                    if (tick > 0)
+                    {
+                        game.world.remove_tile(edit_coords(tick - 1, edit));
+                    }
+
+                    game.world.place_tile(Tile::Brick, edit_coords(tick, edit));
+                }
+            },
+        },
+    };
+}
+
+// each tick is timed from the scenario acting up to the end of the tick, the scenario's own work is reported as the
+// "act" system
+// times are stored in space reserved up front, so allocation tracking builds only report the game's own allocations
+auto run(Scenario const& scenario, const size_t enemy_count, const size_t ticks) -> Result
+{
+    Game game{ Game::Mode::Headless };
+    game.time_systems = true;
+    std::vector<double> tick_times;
+    std::vector<double> act_times;
+    tick_times.reserve(ticks);
+    act_times.reserve(ticks);
+    // in the order the scheduler lists them, which doesn't change between ticks
+    std::vector<std::vector<double>> system_times;
+    for (size_t tick{ 0 }; tick < ticks; tick++)
+    {
+        scenario.prepare(game, enemy_count);
+        const auto start{ Clock::now() };
+        scenario.act(game, tick);
+        act_times.push_back(elapsed_ms(start));
+        game.run_headless(Inputs{}, game.dt());
+        tick_times.push_back(elapsed_ms(start));
+        if (system_times.size() != game.system_times.size())
+        {
+            system_times.resize(game.system_times.size());
+            for (auto& times : system_times)
+            {
+                times.reserve(ticks);
+            }
+        }
+
+        for (size_t i{ 0 }; i < game.system_times.size(); i++)
+        {
+            const std::chrono::duration<double, std::milli> time{ game.system_times[i].time };
+            system_times[i].push_back(time.count());
+        }
+    }
+
+    Result result{
+        .scenario = scenario.name, .enemy_count = enemy_count, .tick = distribution(tick_times), .systems = {}
+    };
+    result.systems.push_back({ .name = "act", .time = distribution(act_times) });
+    for (size_t i{ 0 }; i < system_times.size(); i++)
+    {
+        result.systems.push_back({ .name = std::string{ game.system_times[i].name },
+                                   .time = distribution(std::move(system_times[i])) });
+    }
+
+    const auto median{ [](SystemResult const& system) { return system.time.median_ms; } };
+    std::ranges::sort(result.systems, std::ranges::greater{}, median);
+
+    return result;
+}
+
+auto write_json(std::filesystem::path const& path, std::vector<Result> const& results) -> bool
+{
+    std::ofstream file{ path };
+    file << "{\n  \"results\": [";
+    for (size_t i{ 0 }; i < results.size(); i++)
+    {
+        auto const& result{ results[i] };
+        file << (i == 0 ? "\n" : ",\n");
+        file << std::format(
+            R"(    {{ "scenario": {}, "enemies": {}, "tick": )",
+            ss::json_string(result.scenario),
+            result.enemy_count
+        );
+        write_distribution(file, result.tick);
+        file << ", \"systems\": [";
+        for (size_t j{ 0 }; j < result.systems.size(); j++)
+        {
+            const auto name{ ss::json_string(result.systems[j].name) };
+            file << std::format(R"({}{{ "name": {}, "time": )", j == 0 ? "" : ", ", name);
+            write_distribution(file, result.systems[j].time);
+            file << " }";
+        }
+
+        file << "] }";
+    }
+
+    file << "\n  ]\n}\n";
+    if (!file)
+    {
+        slog::log(slog::ERR, "Failed to write results to {}", path.string());
+
+        return false;
+    }
+
+    slog::log(slog::INF, "Wrote {} results to {}", results.size(), path.string());
+
+    return true;
+}
+} // namespace game_bench
+
+namespace
+{
+auto top_up_enemies(Game& game, const size_t enemy_count) -> void
+{
+    const auto current{ game.entities.ids(Entity::Enemy).size() };
+    const auto missing{ enemy_count - std::min(current, enemy_count) };
+    constexpr auto area_tiles{ ENEMY_AREA_LEN * ENEMY_AREA_LEN };
+    for (size_t tile{ 0 }; tile < area_tiles && tile < missing; tile++)
+    {
+        const auto count{ (missing / area_tiles) + (tile < missing % area_tiles ? 1 : 0) };
+        const Game::Coords coords{ ENEMY_MIN_X + (tile % ENEMY_AREA_LEN), ENEMY_MIN_Y + (tile / ENEMY_AREA_LEN) };
+        game.spawn_enemy(Enemy::Duck, coords, count);
+    }
+}
+
+// scattered over the editing area, so each tick's edits change the shape of the collision boxes
+auto edit_coords(const size_t tick, const size_t edit) -> Game::Coords
+{
+    const auto index{ ((tick * EDITS_PER_TICK) + edit) * 7919 }; // NOLINT(*magic-numbers)
+
+    return { EDIT_MIN_X + (index % EDIT_WIDTH), EDIT_MIN_Y + ((index / EDIT_WIDTH) % EDIT_HEIGHT) };
+}
+
+auto elapsed_ms(const Clock::time_point start) -> double
+{
+    const std::chrono::duration<double, std::milli> elapsed{ Clock::now() - start };
+
+    return elapsed.count();
+}
+
+auto distribution(std::vector<double> times_ms) -> game_bench::Distribution
+{
+    const auto summary{ ss::summarise(std::move(times_ms)) };
+
+    return { .median_ms = summary.median, .p99_ms = summary.p99, .max_ms = summary.max };
+}
+
+auto write_distribution(std::ofstream& file, game_bench::Distribution const& distribution) -> void
+{
+    file << std::format(
+        R"({{ "median_ms": {:.4f}, "p99_ms": {:.4f}, "max_ms": {:.4f} }})",
+        distribution.median_ms,
+        distribution.p99_ms,
+        distribution.max_ms
+    );
+}
+} // namespace
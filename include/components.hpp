@@ -3,6 +3,8 @@
 
 #include "raylib-cpp.hpp" // IWYU pragma: keep
 #include "se-bbox.hpp"
+#include "se-components.hpp"
+#include "se-entities.hpp"
 
 #include <bitset>
 #include <cstdint>
@@ -44,7 +46,10 @@ struct Combat
 
 struct Parent
 {
-    std::optional<size_t> id;
+    std::optional<seb_engine::EntityHandle> id;
 };
 
+using Components
+    = seb_engine::Components<seb_engine::Pos, seb_engine::Vel, seb_engine::BBox, Flags, Combat, Parent>;
+
 #endif
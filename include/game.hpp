@@ -1,18 +1,32 @@
 #ifndef GAME_HPP_
 #define GAME_HPP_
 
+#include "components.hpp"
 #include "entities.hpp"
+#include "inputs.hpp"
 #include "raylib-cpp.hpp" // IWYU pragma: keep
+#include "replay.hpp"
+#include "se-commands.hpp"
 #include "se-components.hpp"
 #include "se-entities.hpp"
+#include "se-hierarchy.hpp"
+#include "se-scheduler.hpp"
+#include "se-spatial.hpp"
 #include "se-tiles.hpp"
 #include "se-ui.hpp"
 #include "seb-engine.hpp"
 #include "settings.hpp"
+#include "sl-jobs.hpp"
 #include "sl-math.hpp"
 #include "sprites.hpp"
 #include "tiles.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <variant>
+#include <vector>
+
 #ifndef NDEBUG
 #define SHOW_CBOXES
 #undef SHOW_CBOXES
@@ -31,53 +45,155 @@ inline constexpr float CAMERA_ZOOM{ 2.0 };
 
 inline constexpr size_t WORLD_WIDTH{ 32 };
 inline constexpr size_t WORLD_HEIGHT{ 16 };
+// about the size of an enemy's hitbox, so most enemies only sit in a cell or two
+inline constexpr float HIT_CELL_SIZE{ 2 * TILE_LEN };
+
+// bumped whenever what is saved in a snapshot changes, including the layout of any component
+inline constexpr uint32_t SNAPSHOT_VERSION{ 1 };
+inline constexpr auto QUICKSAVE_FILE{ "quicksave.snap" };
+
+#ifdef SL_PROFILE
+// F3 toggles the overlay of the last PROFILE_FRAMES frames, F4 writes every recorded zone to TRACE_FILE
+inline constexpr size_t PROFILE_FRAMES{ 120 };
+inline constexpr int PROFILE_WIDTH{ 440 };
+inline constexpr int PROFILE_LINE_HEIGHT{ 16 };
+inline constexpr int PROFILE_FONT_SIZE{ 10 };
+inline constexpr auto TRACE_FILE{ "trace.json" };
+#endif
+
+#ifdef SL_ALLOC_TRACK
+// storage and queues settle into their largest sizes over the first frames, after which frames shouldn't allocate
+inline constexpr size_t ALLOC_WARMUP_FRAMES{ 120 };
+inline constexpr size_t ALLOC_REPORT_SITES{ 5 };
+#endif
 
 inline constexpr seblib::math::Vec2 MELEE_OFFSET{ 32.0, 16.0 };
 inline constexpr seblib::math::Vec2 MELEE_OFFSET_FLIPPED{ -17.0, 16.0 };
 
-struct Inputs
+// position of an entity before the last tick, kept along with its handle so recycled ids aren't interpolated from
+// whatever was in the slot before
+struct PrevPos
+{
+    seb_engine::EntityHandle handle;
+    seb_engine::Pos pos;
+};
+
+// scratch space damage_entities rebuilds every tick, the enemies by hitbox and the ones near the attack being checked
+struct HitScratch
+{
+    seb_engine::SpatialHash enemy_hitboxes{ HIT_CELL_SIZE };
+    std::vector<size_t> candidates;
+};
+
+// scratch space of resolve_tile_collisions, the world's cboxes near the entity being checked
+struct CollisionScratch
+{
+    std::vector<size_t> near_cboxes;
+};
+
+// what an attack's spawn command sets the attack up with once commands are applied
+struct MeleeSpawn
+{
+    raylib::Vector2 source_pos;
+    seb_engine::EntityHandle parent;
+};
+
+struct ProjectileSpawn
 {
-    bool left{ false };
-    bool right{ false };
-    bool up{ false };
-    bool down{ false };
-    bool left_click{ false };
-    bool right_click{ false };
-    bool spawn_enemy{ false };
-    bool pause{ false };
+    raylib::Vector2 source_pos;
+    raylib::Vector2 vel;
 };
 
+struct SectorSpawn
+{
+    raylib::Vector2 source_pos;
+    raylib::Vector2 target_pos;
+    seb_engine::EntityHandle parent;
+};
+
+using AttackSpawn = std::variant<MeleeSpawn, ProjectileSpawn, SectorSpawn>;
+
 struct Game
 {
     using Coords = seb_engine::Coords<TILE_LEN>;
     using World = seb_engine::World<Tile, SpriteTile, WORLD_WIDTH, WORLD_HEIGHT, TILE_LEN>;
+    using Commands = seb_engine::Commands<Entity, Components, AttackSpawn>;
 
-    raylib::Window window{ seb_engine::ui::WINDOW_WIDTH, seb_engine::ui::WINDOW_HEIGHT, WINDOW_TITLE };
+    // headless games never open the window or load the texture sheet, and are driven by inputs passed to
+    // run_headless
+    enum class Mode : uint8_t
+    {
+        Windowed,
+        Headless,
+    };
+
+    raylib::Window window;
     raylib::Camera2D camera{
         raylib::Vector2{ seb_engine::ui::WINDOW_WIDTH, seb_engine::ui::WINDOW_HEIGHT } / 2, {}, 0.0, CAMERA_ZOOM
     };
-    raylib::Texture texture_sheet{ TEXTURE_SHEET };
-    seb_engine::Entities<MAX_ENTITIES, Entity> entities;
-    seb_engine::Components<MAX_ENTITIES> components;
+    raylib::Texture texture_sheet;
+    seb_engine::Entities<Entity> entities;
+    Components components;
     Sprites sprites;
     World world;
-    std::vector<size_t> to_destroy;
+    Commands commands;
+    seb_engine::Hierarchy hierarchy;
+    seblib::jobs::Pool jobs;
+    // drained by the systems which only process changed components
+    size_t flipped_vel_changes{ 0 };
+    size_t children_pos_changes{ 0 };
+    size_t children_flags_changes{ 0 };
+    size_t children_parent_changes{ 0 };
+    std::vector<PrevPos> prev_positions;
+    // reused by spawn_batch
+    std::vector<size_t> batch_ids;
+    // each only touched by its own system, which declares writing it to the scheduler
+    HitScratch hit_scratch;
+    CollisionScratch collision_scratch;
+    // simulation time which has yet to be ticked
+    float accumulator{ 0.0 };
     Inputs inputs;
+    // records the inputs of every frame when set
+    std::optional<replay::Recorder> recorder;
     std::optional<seb_engine::ui::Screen> screen;
+    // when set, each tick replaces system_times with how long every system took, apply_commands included
+    bool time_systems{ false };
+    std::vector<seb_engine::SystemTime> system_times;
     size_t player_id{ 0 };
+    Mode mode{ Mode::Windowed };
     bool paused{ false };
     bool close{ false };
+#ifdef SL_PROFILE
+    bool show_profile{ false };
+#endif
+#ifdef SL_ALLOC_TRACK
+    size_t alloc_frames{ 0 };
+#endif
 
-    Game();
+    explicit Game(Mode mode = Mode::Windowed, size_t max_entities = MAX_ENTITIES);
 
     auto run() -> void;
+    auto run_headless(Inputs const& frame_inputs, float frame_time) -> void;
+    auto update(float frame_time) -> void;
+    auto tick() -> void;
+    auto render() -> void;
+    auto spawn(Entity type) -> size_t;
+    template <typename Prefab, typename Init>
+    auto spawn_batch(Prefab const& prefab, size_t count, Init&& init) -> std::vector<size_t> const&;
+    auto grow_storage() -> void;
     auto spawn_player(Coords coords) -> void;
-    auto spawn_enemy(Enemy enemy, Coords coords) -> void;
+    auto spawn_enemy(Enemy enemy, Coords coords, size_t count = 1) -> void;
     [[nodiscard]] auto dt() const -> float;
-    [[nodiscard]] auto mouse_world_pos() const -> seblib::math::Vec2;
+    [[nodiscard]] auto frame_dt() const -> float;
+    [[nodiscard]] auto render_pos(size_t id) const -> seb_engine::Pos;
+    auto save_prev_positions() -> void;
     auto destroy_entity(size_t id) -> void;
+    auto set_parent(size_t id, seb_engine::EntityHandle parent) -> void;
     auto spawn_attack(Attack attack, size_t parent_id) -> void;
+    auto init_attack(size_t id, AttackSpawn const& spawn) -> void;
     auto toggle_pause() -> void;
+    [[nodiscard]] auto save_snapshot(std::filesystem::path const& path) const -> bool;
+    [[nodiscard]] auto load_snapshot(std::filesystem::path const& path) -> bool;
 
     // systems
     auto poll_inputs() -> void;
@@ -85,7 +201,7 @@ struct Game
     auto set_player_vel() -> void;
     auto move() -> void;
     auto resolve_tile_collisions() -> void;
-    auto destroy_entities() -> void;
+    auto apply_commands() -> void;
     auto player_action() -> void;
     auto update_lifespans() -> void;
     auto damage_entities() -> void;
@@ -97,6 +213,15 @@ struct Game
     auto set_flipped() -> void;
     auto render_damage_lines() -> void;
 
+#ifdef SL_PROFILE
+    auto render_profile() -> void;
+#endif
+
+#ifdef SL_ALLOC_TRACK
+    auto begin_alloc_frame() -> void;
+    auto end_alloc_frame() -> void;
+#endif
+
 #ifdef SHOW_CBOXES
     auto render_cboxes() -> void;
 #endif
@@ -106,4 +231,26 @@ struct Game
 #endif
 };
 
+/****************************
+ *                          *
+ * TEMPLATE IMPLEMENTATIONS *
+ *                          *
+ ****************************/
+
+// spawns up to count entities from the prefab, then calls init(id, index) for each to set what differs between them
+// the returned ids are only valid until the next batch is spawned
+template <typename Prefab, typename Init>
+auto Game::spawn_batch(Prefab const& prefab, const size_t count, Init&& init) -> std::vector<size_t> const&
+{
+    entities.spawn_batch(prefab.type, count, batch_ids);
+    grow_storage();
+    prefab.write(batch_ids, components, sprites);
+    for (size_t i{ 0 }; i < batch_ids.size(); i++)
+    {
+        init(batch_ids[i], i);
+    }
+
+    return batch_ids;
+}
+
 #endif
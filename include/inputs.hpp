@@ -0,0 +1,21 @@
+#ifndef INPUTS_HPP_
+#define INPUTS_HPP_
+
+#include "sl-math.hpp"
+
+struct Inputs
+{
+    bool left{ false };
+    bool right{ false };
+    bool up{ false };
+    bool down{ false };
+    bool left_click{ false };
+    bool right_click{ false };
+    bool spawn_enemy{ false };
+    bool pause{ false };
+    seblib::math::Vec2 mouse_pos;
+    // worked out when polled, so the simulation doesn't depend on the camera
+    seblib::math::Vec2 mouse_world_pos;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef REPLAY_HPP_
+#define REPLAY_HPP_
+
+#include "inputs.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace replay
+{
+// inputs polled at the start of a frame, along with the frame's length
+// load is set when a snapshot was loaded before the frame ran
+struct Frame
+{
+    Inputs inputs;
+    float frame_time{ 0.0 };
+    std::optional<std::filesystem::path> load;
+};
+
+// writes frames to a file as they are recorded, buffered so a frame costs no more than a few bytes of copying
+// the buttons are packed into a byte, and the mouse positions are only written on frames with a click, as nothing
+// else reads them
+// snapshots the game starts from or loads are copied next to the recording, as the originals can be overwritten by
+// later saves
+class Recorder
+{
+public:
+    explicit Recorder(std::filesystem::path const& path, std::optional<std::filesystem::path> const& start = {});
+    Recorder(Recorder const&) = delete;
+    Recorder(Recorder&&) = delete;
+    auto operator=(Recorder const&) -> Recorder& = delete;
+    auto operator=(Recorder&&) -> Recorder& = delete;
+    ~Recorder();
+
+    auto record(Inputs const& inputs, float frame_time) -> void;
+    auto record_load(std::filesystem::path const& snapshot) -> void;
+
+private:
+    std::filesystem::path m_path;
+    std::ofstream m_file;
+    std::vector<std::byte> m_buffer;
+    size_t m_snapshots{ 0 };
+
+    auto flush() -> void;
+    [[nodiscard]] auto copy_snapshot(std::filesystem::path const& snapshot) -> std::string;
+};
+
+// reads the whole recording up front, so replaying never waits on the disk
+class Reader
+{
+public:
+    explicit Reader(std::filesystem::path const& path);
+
+    [[nodiscard]] auto start() const -> std::optional<std::filesystem::path> const&;
+    [[nodiscard]] auto next() -> std::optional<Frame>;
+
+private:
+    std::filesystem::path m_dir;
+    std::vector<std::byte> m_data;
+    size_t m_offset{ 0 };
+    std::optional<std::filesystem::path> m_start;
+};
+} // namespace replay
+
+#endif
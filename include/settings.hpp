@@ -3,6 +3,16 @@
 
 #include <cstddef>
 
-inline constexpr size_t MAX_ENTITIES{ 1024 };
+// entity storage grows a page at a time, up to this many entities unless the game is started with --max-entities
+inline constexpr size_t MAX_ENTITIES{ 65536 };
+
+// a frame has 1 / TARGET_FPS seconds to tick and render in
+inline constexpr unsigned TARGET_FPS{ 60 };
+
+// the simulation steps at a fixed rate, independent of the frame rate, with positions interpolated between ticks when
+// rendering
+inline constexpr unsigned TICK_RATE{ 60 };
+// frames which fall further behind than this drop the extra time, rather than trying to catch up
+inline constexpr unsigned MAX_TICKS_PER_FRAME{ 5 };
 
 #endif
@@ -3,7 +3,6 @@
 
 #include "entities.hpp"
 #include "se-sprite.hpp"
-#include "settings.hpp"
 #include "sl-math.hpp"
 
 #include <cstdint>
@@ -61,7 +60,7 @@ enum class SpriteTile : uint8_t
     Brick,
 };
 
-using Sprites = seb_engine::Sprites<MAX_ENTITIES, SpriteBase, SpriteHead, SpriteArms, SpriteLegs, SpriteExtra>;
+using Sprites = seb_engine::Sprites<SpriteBase, SpriteHead, SpriteArms, SpriteLegs, SpriteExtra>;
 
 namespace sprites
 {
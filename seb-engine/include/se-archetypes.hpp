@@ -0,0 +1,343 @@
+#ifndef SE_ARCHETYPES_HPP_
+#define SE_ARCHETYPES_HPP_
+
+#include "seblib.hpp"
+#include "sl-log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace seb_engine
+{
+namespace sl = seblib;
+
+// entities with the same set of components share an archetype, which stores them in fixed size chunks holding one array
+// per component, so iterating a component set streams through contiguous memory
+// adding or removing a component migrates the entity to another archetype, and destroying an entity moves the last
+// entity of its archetype into its place, so references to components should not be held across either
+template <size_t ChunkSize, typename... Comps>
+class Archetypes
+{
+public:
+    using Signature = std::bitset<sizeof...(Comps)>;
+
+    template <typename... Cs>
+    auto insert(size_t id, Cs... comps) -> void;
+    template <typename Comp>
+    auto add(size_t id, Comp comp) -> void;
+    template <typename Comp>
+    auto remove(size_t id) -> void;
+    auto destroy(size_t id) -> void;
+    template <typename Comp>
+    [[nodiscard]] auto get(size_t id) -> Comp&;
+    template <typename Comp>
+    [[nodiscard]] auto contains(size_t id) const -> bool;
+    [[nodiscard]] auto size() const -> size_t;
+    template <typename... Cs, typename Func>
+    auto each_chunk(Func&& func) -> void;
+    template <typename... Cs, typename Func>
+    auto each(Func&& func) -> void;
+
+    template <typename... Cs>
+    [[nodiscard]] static constexpr auto signature() -> Signature;
+
+private:
+    static constexpr auto NO_ARCHETYPE{ std::numeric_limits<size_t>::max() };
+
+    template <typename Comp>
+    using Column = std::unique_ptr<std::array<Comp, ChunkSize>>;
+    // columns for components outside of the archetype's signature are left unallocated
+    using Chunk = std::tuple<Column<Comps>...>;
+
+    struct Archetype
+    {
+        Signature signature;
+        std::vector<Chunk> chunks;
+        // maps rows to entity ids
+        std::vector<size_t> ids;
+    };
+
+    struct Location
+    {
+        size_t archetype{ NO_ARCHETYPE };
+        size_t row{ 0 };
+    };
+
+    std::vector<Archetype> m_archetypes;
+    std::unordered_map<Signature, size_t> m_archetype_ids;
+    std::vector<Location> m_locations;
+
+    template <typename Comp>
+    [[nodiscard]] static consteval auto bit() -> size_t;
+    template <typename Comp>
+    [[nodiscard]] static auto column(Archetype& archetype, size_t row) -> Comp&;
+
+    [[nodiscard]] auto lookup_archetype(Signature signature) -> size_t;
+    [[nodiscard]] auto push_row(size_t archetype_id, size_t id) -> size_t;
+    auto remove_row(size_t archetype_id, size_t row) -> void;
+    auto migrate(size_t id, Signature signature) -> void;
+};
+} // namespace seb_engine
+
+/****************************
+ *                          *
+ * TEMPLATE IMPLEMENTATIONS *
+ *                          *
+ ****************************/
+
+namespace seb_engine
+{
+namespace slog = seblib::log;
+
+// replaces the entity's components if it already has any
+template <size_t ChunkSize, typename... Comps>
+template <typename... Cs>
+auto Archetypes<ChunkSize, Comps...>::insert(const size_t id, Cs... comps) -> void
+{
+    destroy(id);
+    const auto archetype_id{ lookup_archetype(signature<Cs...>()) };
+    const auto row{ push_row(archetype_id, id) };
+    m_locations[id] = { .archetype = archetype_id, .row = row };
+    auto& archetype{ m_archetypes[archetype_id] };
+    ((column<Cs>(archetype, row) = std::move(comps)), ...);
+}
+
+template <size_t ChunkSize, typename... Comps>
+template <typename Comp>
+auto Archetypes<ChunkSize, Comps...>::add(const size_t id, Comp comp) -> void
+{
+    if (!contains<Comp>(id))
+    {
+        const auto current{ (id < m_locations.size() && m_locations[id].archetype != NO_ARCHETYPE
+                                 ? m_archetypes[m_locations[id].archetype].signature
+                                 : Signature{}) };
+        migrate(id, current | signature<Comp>());
+    }
+
+    get<Comp>(id) = std::move(comp);
+}
+
+template <size_t ChunkSize, typename... Comps>
+template <typename Comp>
+auto Archetypes<ChunkSize, Comps...>::remove(const size_t id) -> void
+{
+    if (contains<Comp>(id))
+    {
+        migrate(id, m_archetypes[m_locations[id].archetype].signature & ~signature<Comp>());
+    }
+}
+
+template <size_t ChunkSize, typename... Comps>
+auto Archetypes<ChunkSize, Comps...>::destroy(const size_t id) -> void
+{
+    if (id >= m_locations.size() || m_locations[id].archetype == NO_ARCHETYPE)
+    {
+        return;
+    }
+
+    const auto location{ m_locations[id] };
+    remove_row(location.archetype, location.row);
+    m_locations[id] = {};
+}
+
+template <size_t ChunkSize, typename... Comps>
+template <typename Comp>
+auto Archetypes<ChunkSize, Comps...>::get(const size_t id) -> Comp&
+{
+#ifndef NDEBUG
+    if (!contains<Comp>(id))
+    {
+        slog::log(slog::FTL, "Entity {} does not have component {}", id, typeid(Comp).name());
+    }
+#endif
+
+    const auto location{ m_locations[id] };
+
+    return column<Comp>(m_archetypes[location.archetype], location.row);
+}
+
+template <size_t ChunkSize, typename... Comps>
+template <typename Comp>
+auto Archetypes<ChunkSize, Comps...>::contains(const size_t id) const -> bool
+{
+    return id < m_locations.size()
+        && m_locations[id].archetype != NO_ARCHETYPE
+        && m_archetypes[m_locations[id].archetype].signature[bit<Comp>()];
+}
+
+template <size_t ChunkSize, typename... Comps>
+auto Archetypes<ChunkSize, Comps...>::size() const -> size_t
+{
+    size_t size{ 0 };
+    for (const auto& archetype : m_archetypes)
+    {
+        size += archetype.ids.size();
+    }
+
+    return size;
+}
+
+// calls func(ids, components...) once per chunk of every archetype containing Cs, where ids and each component are
+// spans covering the chunk's occupied rows
+template <size_t ChunkSize, typename... Comps>
+template <typename... Cs, typename Func>
+auto Archetypes<ChunkSize, Comps...>::each_chunk(Func&& func) -> void
+{
+    const auto required{ signature<Cs...>() };
+    for (auto& archetype : m_archetypes)
+    {
+        if ((archetype.signature & required) != required)
+        {
+            continue;
+        }
+
+        const auto rows{ archetype.ids.size() };
+        for (size_t chunk_id{ 0 }; chunk_id * ChunkSize < rows; chunk_id++)
+        {
+            const auto first_row{ chunk_id * ChunkSize };
+            const auto count{ std::min(ChunkSize, rows - first_row) };
+            auto& chunk{ archetype.chunks[chunk_id] };
+            func(
+                std::span<const size_t>{ archetype.ids.data() + first_row, count },
+                std::span<Cs>{ std::get<Column<Cs>>(chunk)->data(), count }...
+            );
+        }
+    }
+}
+
+// calls func(id, components&...) for every entity containing Cs
+template <size_t ChunkSize, typename... Comps>
+template <typename... Cs, typename Func>
+auto Archetypes<ChunkSize, Comps...>::each(Func&& func) -> void
+{
+    each_chunk<Cs...>(
+        [&func](const std::span<const size_t> ids, const std::span<Cs>... comps)
+        {
+            for (size_t i{ 0 }; i < ids.size(); i++)
+            {
+                func(ids[i], comps[i]...);
+            }
+        }
+    );
+}
+
+template <size_t ChunkSize, typename... Comps>
+template <typename... Cs>
+constexpr auto Archetypes<ChunkSize, Comps...>::signature() -> Signature
+{
+    Signature signature;
+    (signature.set(bit<Cs>()), ...);
+
+    return signature;
+}
+
+template <size_t ChunkSize, typename... Comps>
+template <typename Comp>
+consteval auto Archetypes<ChunkSize, Comps...>::bit() -> size_t
+{
+    return sl::index_of<Comp, Comps...>();
+}
+
+template <size_t ChunkSize, typename... Comps>
+template <typename Comp>
+auto Archetypes<ChunkSize, Comps...>::column(Archetype& archetype, const size_t row) -> Comp&
+{
+    return (*std::get<Column<Comp>>(archetype.chunks[row / ChunkSize]))[row % ChunkSize];
+}
+
+template <size_t ChunkSize, typename... Comps>
+auto Archetypes<ChunkSize, Comps...>::lookup_archetype(const Signature signature) -> size_t
+{
+    const auto [it, inserted]{ m_archetype_ids.try_emplace(signature, m_archetypes.size()) };
+    if (inserted)
+    {
+        slog::log(slog::TRC, "Creating archetype {}", signature.to_string());
+        m_archetypes.push_back({ .signature = signature, .chunks = {}, .ids = {} });
+    }
+
+    return it->second;
+}
+
+template <size_t ChunkSize, typename... Comps>
+auto Archetypes<ChunkSize, Comps...>::push_row(const size_t archetype_id, const size_t id) -> size_t
+{
+    if (id >= m_locations.size())
+    {
+        m_locations.resize(id + 1);
+    }
+
+    auto& archetype{ m_archetypes[archetype_id] };
+    const auto row{ archetype.ids.size() };
+    if (row == archetype.chunks.size() * ChunkSize)
+    {
+        const auto signature{ archetype.signature };
+        archetype.chunks.emplace_back(
+            (signature[bit<Comps>()] ? std::make_unique<std::array<Comps, ChunkSize>>() : nullptr)...
+        );
+    }
+
+    archetype.ids.push_back(id);
+
+    return row;
+}
+
+template <size_t ChunkSize, typename... Comps>
+auto Archetypes<ChunkSize, Comps...>::remove_row(const size_t archetype_id, const size_t row) -> void
+{
+    auto& archetype{ m_archetypes[archetype_id] };
+    const auto last_row{ archetype.ids.size() - 1 };
+    if (row != last_row)
+    {
+        const auto move_last{ [&archetype, row, last_row]<typename Comp>()
+                              {
+                                  if (archetype.signature[bit<Comp>()])
+                                  {
+                                      column<Comp>(archetype, row) = std::move(column<Comp>(archetype, last_row));
+                                  }
+                              } };
+        (move_last.template operator()<Comps>(), ...);
+        const auto moved_id{ archetype.ids[last_row] };
+        archetype.ids[row] = moved_id;
+        m_locations[moved_id].row = row;
+    }
+
+    archetype.ids.pop_back();
+}
+
+template <size_t ChunkSize, typename... Comps>
+auto Archetypes<ChunkSize, Comps...>::migrate(const size_t id, const Signature signature) -> void
+{
+    const auto old_location{ (id < m_locations.size() ? m_locations[id] : Location{}) };
+    const auto new_archetype_id{ lookup_archetype(signature) };
+    const auto new_row{ push_row(new_archetype_id, id) };
+    if (old_location.archetype != NO_ARCHETYPE)
+    {
+        auto& old_archetype{ m_archetypes[old_location.archetype] };
+        auto& new_archetype{ m_archetypes[new_archetype_id] };
+        const auto shared{ old_archetype.signature & new_archetype.signature };
+        const auto move_shared{ [&, shared]<typename Comp>()
+                                {
+                                    if (shared[bit<Comp>()])
+                                    {
+                                        column<Comp>(new_archetype, new_row)
+                                            = std::move(column<Comp>(old_archetype, old_location.row));
+                                    }
+                                } };
+        (move_shared.template operator()<Comps>(), ...);
+        remove_row(old_location.archetype, old_location.row);
+    }
+
+    m_locations[id] = { .archetype = new_archetype_id, .row = new_row };
+}
+} // namespace seb_engine
+
+#endif
@@ -63,6 +63,7 @@ private:
 namespace bbox
 {
 auto collides(BBoxVariant bbox1, BBoxVariant bbox2) -> bool;
+auto bounds(BBoxVariant bbox) -> rl::Rectangle;
 auto resolve_collision(BBoxVariant bbox1, BBoxVariant bbox2) -> sm::Vec2;
 } // namespace bbox
 } // namespace seb_engine
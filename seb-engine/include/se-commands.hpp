@@ -0,0 +1,152 @@
+#ifndef SE_COMMANDS_HPP_
+#define SE_COMMANDS_HPP_
+
+#include "se-components.hpp"
+#include "se-entities.hpp"
+#include "seblib.hpp"
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace seb_engine
+{
+namespace sl = seblib;
+
+template <sl::Enumerable Entity, typename Components, typename SpawnArgs>
+class Commands;
+
+// records spawns, destructions and component additions made while systems run, to be applied in a single pass once
+// they are done, so systems never see entities appear or disappear part way through
+// each spawn carries SpawnArgs, whatever its entity needs to be set up with once it exists, which are plain values so
+// recording a spawn only copies them into a buffer reused from one apply to the next
+template <sl::Enumerable Entity, typename... Comps, typename SpawnArgs>
+class Commands<Entity, Components<Comps...>, SpawnArgs>
+{
+public:
+    auto spawn(Entity type, SpawnArgs const& args) -> void;
+    auto destroy(EntityHandle handle) -> void;
+    template <typename Comp>
+    auto add(EntityHandle handle, Comp comp) -> void;
+    [[nodiscard]] auto empty() const -> bool;
+    template <typename Spawn, typename Init, typename Destroy>
+    auto apply(
+        Entities<Entity>& entities, Components<Comps...>& components, Spawn&& spawn, Init&& init, Destroy&& destroy
+    ) -> void;
+
+private:
+    static_assert(std::is_trivially_copyable_v<SpawnArgs>);
+
+    std::vector<std::pair<Entity, SpawnArgs>> m_spawns;
+    std::vector<EntityHandle> m_destroys;
+    // ids can't be reused until the commands are applied, so duplicate destructions can be caught by id
+    std::vector<bool> m_destroy_queued;
+    std::tuple<std::vector<std::pair<EntityHandle, Comps>>...> m_adds;
+};
+} // namespace seb_engine
+
+/****************************
+ *                          *
+ * TEMPLATE IMPLEMENTATIONS *
+ *                          *
+ ****************************/
+
+namespace seb_engine
+{
+// the args are passed to init along with the new entity's id when the commands are applied
+template <sl::Enumerable Entity, typename... Comps, typename SpawnArgs>
+auto Commands<Entity, Components<Comps...>, SpawnArgs>::spawn(const Entity type, SpawnArgs const& args) -> void
+{
+    m_spawns.emplace_back(type, args);
+}
+
+template <sl::Enumerable Entity, typename... Comps, typename SpawnArgs>
+auto Commands<Entity, Components<Comps...>, SpawnArgs>::destroy(const EntityHandle handle) -> void
+{
+    if (handle.id >= m_destroy_queued.size())
+    {
+        m_destroy_queued.resize(handle.id + 1);
+    }
+    else if (m_destroy_queued[handle.id])
+    {
+        return;
+    }
+
+    m_destroy_queued[handle.id] = true;
+    m_destroys.push_back(handle);
+}
+
+template <sl::Enumerable Entity, typename... Comps, typename SpawnArgs>
+template <typename Comp>
+auto Commands<Entity, Components<Comps...>, SpawnArgs>::add(const EntityHandle handle, Comp comp) -> void
+{
+    std::get<std::vector<std::pair<EntityHandle, Comp>>>(m_adds).emplace_back(handle, std::move(comp));
+}
+
+template <sl::Enumerable Entity, typename... Comps, typename SpawnArgs>
+auto Commands<Entity, Components<Comps...>, SpawnArgs>::empty() const -> bool
+{
+    return m_spawns.empty()
+        && m_destroys.empty()
+        && (std::get<std::vector<std::pair<EntityHandle, Comps>>>(m_adds).empty() && ...);
+}
+
+// additions are applied first, skipping entities that are about to be destroyed, then destructions, then spawns so they
+// can reuse the ids that were just freed
+// spawn(type) is called to create each entity and returns its id or NO_ENTITY, init(id, args) is called to set up
+// each entity created, and destroy(id) is called with the id of each entity to destroy, allowing any setup or cleanup
+// beyond the entity and its components
+template <sl::Enumerable Entity, typename... Comps, typename SpawnArgs>
+template <typename Spawn, typename Init, typename Destroy>
+auto Commands<Entity, Components<Comps...>, SpawnArgs>::apply(
+    Entities<Entity>& entities, Components<Comps...>& components, Spawn&& spawn, Init&& init, Destroy&& destroy
+) -> void
+{
+    const auto apply_adds{ [&]<typename Comp>()
+                           {
+                               auto& adds{ std::get<std::vector<std::pair<EntityHandle, Comp>>>(m_adds) };
+                               for (auto& [handle, comp] : adds)
+                               {
+                                   if (entities.valid(handle)
+                                       && (handle.id >= m_destroy_queued.size() || !m_destroy_queued[handle.id]))
+                                   {
+                                       components.template add<Comp>(handle.id) = std::move(comp);
+                                   }
+                               }
+
+                               adds.clear();
+                           } };
+    (apply_adds.template operator()<Comps>(), ...);
+
+    for (const auto handle : m_destroys)
+    {
+        // destroying an entity can destroy others queued after it, such as its children
+        if (entities.valid(handle))
+        {
+            destroy(handle.id);
+        }
+    }
+
+    m_destroys.clear();
+    m_destroy_queued.clear();
+
+    // spawning can queue further commands, which are left for the next call, and may grow the buffer, so each spawn is
+    // copied out before it is used
+    const auto spawn_count{ m_spawns.size() };
+    for (size_t i{ 0 }; i < spawn_count; i++)
+    {
+        const auto [type, args]{ m_spawns[i] };
+        const auto id{ spawn(type) };
+        if (id != NO_ENTITY)
+        {
+            init(id, args);
+        }
+    }
+
+    m_spawns.erase(m_spawns.begin(), m_spawns.begin() + static_cast<std::ptrdiff_t>(spawn_count));
+}
+} // namespace seb_engine
+
+#endif
@@ -1,87 +1,230 @@
 #ifndef SE_COMPONENTS_HPP_
 #define SE_COMPONENTS_HPP_
 
+#include "se-paged.hpp"
+#include "se-snapshot.hpp"
+#include "seblib.hpp"
+#include "sl-jobs.hpp"
 #include "sl-log.hpp"
 #include "sl-math.hpp"
 
+#include <algorithm>
+#include <bitset>
 #include <cstddef>
-#include <memory>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace seb_engine
 {
+namespace sl = seblib;
 namespace sm = seblib::math;
+namespace sj = seblib::jobs;
 
-class IComp
+// dense storage holds a component for every id, sparse storage only holds components for ids that have been accessed
+enum class Storage : uint8_t
 {
-public:
-    IComp(const IComp&) = default;
-    IComp(IComp&&) = default;
-    virtual ~IComp() = default;
-
-    virtual auto reset(size_t id) -> void = 0;
-
-    auto operator=(const IComp&) -> IComp& = default;
-    auto operator=(IComp&&) -> IComp& = default;
-
-protected:
-    IComp() = default;
+    Dense,
+    Sparse,
 };
 
-template <size_t MaxEntities, typename Comp>
-class Component : public IComp
+// storage is paged, so growing it never moves existing components
+// with sparse storage, removing a component moves the last component into its place, so references to sparse
+// components should not be held across destroying entities
+template <typename Comp>
+class Component
 {
 public:
-    auto reset(size_t id) -> void override;
-    auto vec() -> std::vector<Comp>&;
+    // the snapshot sections holding the storage, viewed in place in the reader's mapping, only sparse storage has
+    // sparse and owners
+    struct Sections
+    {
+        std::span<const Comp> vec;
+        std::span<const size_t> sparse;
+        std::span<const size_t> owners;
+    };
+
+    Component();
+    explicit Component(Storage storage);
+
+    auto resize(size_t capacity) -> void;
+    auto reset(size_t id) -> void;
+    [[maybe_unused]] auto add(size_t id) -> Comp&;
+    [[nodiscard]] auto get(size_t id) -> Comp&;
+    [[nodiscard]] auto get(size_t id) const -> Comp const&;
+    [[nodiscard]] auto contains(size_t id) const -> bool;
+    auto vec() -> Paged<Comp>&;
+    [[nodiscard]] auto vec() const -> Paged<Comp> const&;
+    [[nodiscard]] auto owners() const -> std::vector<size_t> const&;
+    [[nodiscard]] auto track() -> size_t;
+    auto mark_changed(size_t id) -> void;
+    template <typename Func>
+    auto drain_changed(size_t tracker, Func&& func) -> void;
+    auto save(snapshot::Writer& writer) const -> void;
+    [[nodiscard]] auto read(snapshot::Reader& reader, size_t capacity) const -> Sections;
+    auto load(Sections const& sections, size_t capacity) -> void;
 
 private:
-    std::vector<Comp> m_vec{ MaxEntities, Comp{} };
+    static constexpr auto NO_INDEX{ std::numeric_limits<size_t>::max() };
+
+    // ids changed since the tracker was last drained, each listed once
+    struct Changes
+    {
+        std::vector<size_t> ids;
+        Paged<bool> queued;
+    };
+
+    Storage m_storage;
+    // indexed by id with dense storage, packed with sparse storage
+    Paged<Comp> m_vec;
+    // sparse storage only, m_sparse maps ids to indices of m_vec, m_owners maps indices of m_vec back to ids
+    Paged<size_t> m_sparse;
+    std::vector<size_t> m_owners;
+    std::vector<Changes> m_changes;
+
+    [[nodiscard]] auto consistent(Sections const& sections, size_t capacity) const -> bool;
 };
 
-template <size_t MaxEntities>
+template <typename... Comps>
 class EntityComponents;
 
-template <size_t MaxEntities>
+// every component type is known up front, so looking up a component's storage is resolved at compile time
+// each id has a signature recording which components it has, which is what views are matched against
+// storage must be grown with resize to cover every id before it is used
+// components are only added to an id by add, insert or loading, get and try_get never change a signature
+// changes are not detected automatically, systems writing a tracked component should call mark_changed so systems
+// draining its changes only process what was modified
+template <typename... Comps>
 class Components
 {
 public:
+    using Signature = std::bitset<sizeof...(Comps)>;
+
+    // the snapshot sections holding the signatures and every component's storage, viewed in place in the reader's
+    // mapping
+    struct Sections
+    {
+        std::span<const Signature> signatures;
+        std::tuple<typename Component<Comps>::Sections...> components;
+    };
+
+    auto resize(size_t capacity) -> void;
     auto uninit(size_t id) -> void;
-    [[nodiscard]] auto by_id(size_t id) -> EntityComponents<MaxEntities>;
+    [[nodiscard]] auto by_id(size_t id) -> EntityComponents<Comps...>;
+    template <typename Comp>
+    [[maybe_unused]] auto reg(Storage storage = Storage::Dense) -> Component<Comp>*;
+    template <typename Comp>
+    [[nodiscard]] auto vec() -> Paged<Comp>&;
     template <typename Comp>
-    [[maybe_unused]] auto reg() -> Component<MaxEntities, Comp>*;
+    [[nodiscard]] auto vec() const -> Paged<Comp> const&;
     template <typename Comp>
-    [[nodiscard]] auto vec() -> std::vector<Comp>&;
+    [[nodiscard]] auto owners() -> std::vector<size_t> const&;
+    template <typename Comp>
+    [[maybe_unused]] auto add(size_t id) -> Comp&;
     template <typename Comp>
     [[nodiscard]] auto get(size_t id) -> Comp&;
+    template <typename Comp>
+    [[nodiscard]] auto get(size_t id) const -> Comp const&;
+    template <typename Comp>
+    [[nodiscard]] auto try_get(size_t id) -> Comp*;
+    template <typename Comp>
+    [[nodiscard]] auto try_get(size_t id) const -> Comp const*;
+    template <typename Comp>
+    [[nodiscard]] auto contains(size_t id) const -> bool;
+    template <typename... Cs>
+    auto insert(std::span<const size_t> ids, Cs const&... comps) -> void;
+    template <typename... Cs>
+    [[nodiscard]] auto ids() -> std::vector<size_t> const&;
+    template <typename... Cs>
+    [[nodiscard]] auto view();
+    template <typename... Cs, typename Func>
+    auto par_each(sj::Pool& pool, size_t chunk_size, Func&& func) -> void;
+    template <typename... Cs, typename Func, typename Deferred>
+    auto par_each(sj::Pool& pool, size_t chunk_size, Func&& func, Deferred&& deferred) -> void;
+    template <typename Comp>
+    [[nodiscard]] auto track() -> size_t;
+    template <typename Comp>
+    auto mark_changed(size_t id) -> void;
+    template <typename Comp, typename Func>
+    auto drain_changed(size_t tracker, Func&& func) -> void;
     auto move(float dt) -> void;
+    auto save(snapshot::Writer& writer) const -> void;
+    template <sl::Enumerable Entity>
+    [[nodiscard]] auto read(snapshot::Reader& reader, std::span<const Entity> entities) const -> Sections;
+    auto load(Sections const& sections) -> void;
 
-    friend class EntityComponents<MaxEntities>;
+    friend class EntityComponents<Comps...>;
 
 private:
-    std::unordered_map<size_t, std::unique_ptr<IComp>> m_components;
+    // ids is brought up to date on use by merging in the ids in changed, rather than by scanning every signature
+    struct ViewCache
+    {
+        std::vector<size_t> ids;
+        // ids whose signature gained or lost a required component since ids was last brought up to date
+        std::vector<size_t> changed;
+        // swapped with ids when merging, so neither stops allocating once grown
+        std::vector<size_t> merged;
+        // set when changes weren't tracked, so every signature is scanned
+        bool rebuild{ true };
+    };
+
+    std::tuple<Component<Comps>...> m_components;
+    Paged<Signature> m_signatures;
+    // keyed by the components a view requires
+    std::unordered_map<Signature, ViewCache> m_views;
+    // systems reading signatures can run at the same time, and each can rebuild a view
+    std::mutex m_views_mutex;
+    // per chunk deferred ids for par_each, kept between calls so they stop allocating once grown
+    // par_each calls can overlap, so each takes a set of its own
+    std::vector<std::vector<std::vector<size_t>>> m_deferred;
+    std::mutex m_deferred_mutex;
 
     template <typename Comp>
-    auto component() -> Component<MaxEntities, Comp>*;
+    auto component() -> Component<Comp>&;
+    template <typename Comp>
+    auto component() const -> Component<Comp> const&;
+    template <typename Comp>
+    auto check_contains(size_t id) const -> void;
+    auto signature_changed(size_t id, Signature bits) -> void;
+    auto rebuild_views() -> void;
+    auto update_view(Signature required, ViewCache& cache) -> void;
+    auto take_deferred(size_t chunks, size_t chunk_size) -> std::vector<std::vector<size_t>>;
+    auto return_deferred(std::vector<std::vector<size_t>> chunk_deferred) -> void;
 };
 
-template <size_t MaxEntities>
+template <typename... Comps>
 class EntityComponents
 {
 public:
     EntityComponents() = delete;
 
+    template <typename Comp>
+    [[maybe_unused]] auto add() -> Comp&;
     template <typename Comp>
     [[nodiscard]] auto get() -> Comp&;
+    template <typename Comp>
+    [[nodiscard]] auto try_get() -> Comp*;
 
-    friend class Components<MaxEntities>;
+    friend class Components<Comps...>;
 
 private:
-    Components<MaxEntities>* m_components;
+    Components<Comps...>* m_components;
     size_t m_id;
 
-    EntityComponents(Components<MaxEntities>& components, size_t id);
+    EntityComponents(Components<Comps...>& components, size_t id);
+};
+
+// stands in for every entity's signature in scheduler access declarations
+// views read signatures, and systems which add components to entities, such as by calling add, write them
+struct Signatures
+{
 };
 
 struct Position;
@@ -101,79 +244,802 @@ namespace seb_engine
 {
 namespace slog = seblib::log;
 
-template <size_t MaxEntities, typename Comp>
-auto Component<MaxEntities, Comp>::reset(const size_t id) -> void
+template <typename Comp>
+Component<Comp>::Component()
+    : Component{ Storage::Dense }
 {
-    m_vec[id] = Comp{};
 }
 
-template <size_t MaxEntities, typename Comp>
-auto Component<MaxEntities, Comp>::vec() -> std::vector<Comp>&
+template <typename Comp>
+Component<Comp>::Component(const Storage storage)
+    : m_storage{ storage }
+{
+}
+
+template <typename Comp>
+auto Component<Comp>::resize(const size_t capacity) -> void
+{
+    for (auto& changes : m_changes)
+    {
+        if (capacity > changes.queued.size())
+        {
+            changes.queued.resize(capacity, false);
+        }
+    }
+
+    switch (m_storage)
+    {
+    case Storage::Dense:
+        if (capacity > m_vec.size())
+        {
+            m_vec.resize(capacity);
+        }
+
+        break;
+    case Storage::Sparse:
+        if (capacity > m_sparse.size())
+        {
+            m_sparse.resize(capacity, NO_INDEX);
+        }
+
+        break;
+    }
+}
+
+template <typename Comp>
+auto Component<Comp>::reset(const size_t id) -> void
+{
+    if (m_storage == Storage::Dense)
+    {
+        m_vec[id] = Comp{};
+
+        return;
+    }
+
+    const auto index{ m_sparse[id] };
+    if (index == NO_INDEX)
+    {
+        return;
+    }
+
+    const auto last_owner{ m_owners.back() };
+    m_vec[index] = std::move(m_vec.back());
+    m_owners[index] = last_owner;
+    m_sparse[last_owner] = index;
+    m_vec.pop_back();
+    m_owners.pop_back();
+    m_sparse[id] = NO_INDEX;
+}
+
+// with sparse storage, a default constructed component is added if the id does not have one yet
+template <typename Comp>
+auto Component<Comp>::add(const size_t id) -> Comp&
+{
+    if (m_storage == Storage::Dense)
+    {
+        return m_vec[id];
+    }
+
+    auto& index{ m_sparse[id] };
+    if (index == NO_INDEX)
+    {
+        index = m_vec.size();
+        m_vec.emplace_back();
+        m_owners.push_back(id);
+    }
+
+    return m_vec[index];
+}
+
+// with sparse storage, the id must already have the component
+template <typename Comp>
+auto Component<Comp>::get(const size_t id) -> Comp&
+{
+    return m_vec[m_storage == Storage::Dense ? id : m_sparse[id]];
+}
+
+template <typename Comp>
+auto Component<Comp>::get(const size_t id) const -> Comp const&
+{
+    return m_vec[m_storage == Storage::Dense ? id : m_sparse[id]];
+}
+
+template <typename Comp>
+auto Component<Comp>::contains(const size_t id) const -> bool
+{
+    return m_storage == Storage::Dense || m_sparse[id] != NO_INDEX;
+}
+
+template <typename Comp>
+auto Component<Comp>::vec() -> Paged<Comp>&
 {
     return m_vec;
 }
 
-template <size_t MaxEntities>
-auto Components<MaxEntities>::uninit(const size_t id) -> void
+template <typename Comp>
+auto Component<Comp>::vec() const -> Paged<Comp> const&
+{
+    return m_vec;
+}
+
+// only meaningful with sparse storage, where it lines up with vec()
+template <typename Comp>
+auto Component<Comp>::owners() const -> std::vector<size_t> const&
+{
+#ifndef NDEBUG
+    if (m_storage != Storage::Sparse)
+    {
+        slog::log(slog::FTL, "Owners requested for dense component {}", typeid(Comp).name());
+    }
+#endif
+
+    return m_owners;
+}
+
+// registers a consumer of Comp's changes, returning the tracker to drain them with
+// each tracker sees every change independently of the others
+template <typename Comp>
+auto Component<Comp>::track() -> size_t
+{
+    auto& changes{ m_changes.emplace_back() };
+    changes.queued.resize((m_storage == Storage::Dense ? m_vec.size() : m_sparse.size()), false);
+
+    return m_changes.size() - 1;
+}
+
+template <typename Comp>
+auto Component<Comp>::mark_changed(const size_t id) -> void
+{
+    for (auto& changes : m_changes)
+    {
+        if (!changes.queued[id])
+        {
+            changes.queued[id] = true;
+            changes.ids.push_back(id);
+        }
+    }
+}
+
+// calls func(id) for each id changed since the tracker was last drained
+// changes marked by func are drained in the same call, so an entity changed again after being visited is visited again
+template <typename Comp>
+template <typename Func>
+auto Component<Comp>::drain_changed(const size_t tracker, Func&& func) -> void
+{
+    auto& changes{ m_changes[tracker] };
+    for (size_t i{ 0 }; i < changes.ids.size(); i++)
+    {
+        const auto id{ changes.ids[i] };
+        changes.queued[id] = false;
+        func(id);
+    }
+
+    changes.ids.clear();
+}
+
+template <typename Comp>
+auto Component<Comp>::save(snapshot::Writer& writer) const -> void
+{
+    writer.write_value(m_storage);
+    writer.write(m_vec);
+    if (m_storage == Storage::Sparse)
+    {
+        writer.write(m_sparse);
+        writer.write(std::span<const size_t>{ m_owners });
+    }
+}
+
+// the storage has to match the saved storage, as it is picked when registering rather than by the snapshot
+// nothing is changed, the storage is only replaced by passing what is returned to load
+template <typename Comp>
+auto Component<Comp>::read(snapshot::Reader& reader, const size_t capacity) const -> Sections
+{
+    if (reader.read_value<Storage>() != m_storage && reader.ok())
+    {
+        slog::log(slog::ERR, "{} was saved with different storage", typeid(Comp).name());
+        reader.fail("a component's storage does not match");
+    }
+
+    Sections sections{ .vec = reader.read<Comp>(), .sparse = {}, .owners = {} };
+    if (m_storage == Storage::Sparse)
+    {
+        sections.sparse = reader.read<size_t>();
+        sections.owners = reader.read<size_t>();
+    }
+
+    if (reader.ok() && !consistent(sections, capacity))
+    {
+        reader.fail("a component's storage is inconsistent");
+    }
+
+    return sections;
+}
+
+// sections must have been returned by read from a reader which is still ok
+// pending changes are dropped, it is up to the caller to mark what it wants systems to revisit
+template <typename Comp>
+auto Component<Comp>::load(Sections const& sections, const size_t capacity) -> void
+{
+    m_vec.assign(sections.vec);
+    if (m_storage == Storage::Sparse)
+    {
+        m_sparse.assign(sections.sparse);
+        m_owners.assign(sections.owners.begin(), sections.owners.end());
+    }
+
+    for (auto& changes : m_changes)
+    {
+        changes.ids.clear();
+        // shrinking resets the flags
+        changes.queued.resize(0);
+        changes.queued.resize(capacity, false);
+    }
+}
+
+// each owner has to map back to its own index, and no other id can map to an index at all
+template <typename Comp>
+auto Component<Comp>::consistent(Sections const& sections, const size_t capacity) const -> bool
+{
+    if (m_storage == Storage::Dense)
+    {
+        return sections.vec.size() == capacity;
+    }
+
+    if (sections.sparse.size() != capacity || sections.owners.size() != sections.vec.size())
+    {
+        return false;
+    }
+
+    for (size_t index{ 0 }; index < sections.owners.size(); index++)
+    {
+        const auto id{ sections.owners[index] };
+        if (id >= capacity || sections.sparse[id] != index)
+        {
+            return false;
+        }
+    }
+
+    const auto mapped{ std::ranges::count_if(sections.sparse, [](const size_t index) { return index != NO_INDEX; }) };
+
+    return static_cast<size_t>(mapped) == sections.owners.size();
+}
+
+// only grows, as ids are never released
+template <typename... Comps>
+auto Components<Comps...>::resize(const size_t capacity) -> void
+{
+    if (capacity <= m_signatures.size())
+    {
+        return;
+    }
+
+    m_signatures.resize(capacity);
+    (component<Comps>().resize(capacity), ...);
+    rebuild_views();
+}
+
+template <typename... Comps>
+auto Components<Comps...>::uninit(const size_t id) -> void
 {
-    for (auto& [_, component] : m_components)
+    (component<Comps>().reset(id), ...);
+    if (m_signatures[id].any())
     {
-        component->reset(id);
+        signature_changed(id, m_signatures[id]);
+        m_signatures[id].reset();
     }
 }
 
-template <size_t MaxEntities>
-auto Components<MaxEntities>::by_id(const size_t id) -> EntityComponents<MaxEntities>
+template <typename... Comps>
+auto Components<Comps...>::by_id(const size_t id) -> EntityComponents<Comps...>
 {
     return { *this, id };
 }
 
-template <size_t MaxEntities>
+// components default to dense storage, registering is only required to pick a different storage
+template <typename... Comps>
 template <typename Comp>
-auto Components<MaxEntities>::reg() -> Component<MaxEntities, Comp>*
+auto Components<Comps...>::reg(const Storage storage) -> Component<Comp>*
 {
-    m_components.emplace(typeid(Comp).hash_code(), std::make_unique<Component<MaxEntities, Comp>>());
+    auto& comp{ component<Comp>() };
+    comp = Component<Comp>{ storage };
+    comp.resize(m_signatures.size());
+
+    return &comp;
+}
 
-    return component<Comp>();
+template <typename... Comps>
+template <typename Comp>
+auto Components<Comps...>::vec() -> Paged<Comp>&
+{
+    return component<Comp>().vec();
 }
 
-template <size_t MaxEntities>
+template <typename... Comps>
 template <typename Comp>
-auto Components<MaxEntities>::vec() -> std::vector<Comp>&
+auto Components<Comps...>::vec() const -> Paged<Comp> const&
 {
-    return component<Comp>()->vec();
+    return component<Comp>().vec();
 }
 
-template <size_t MaxEntities>
+template <typename... Comps>
 template <typename Comp>
-auto Components<MaxEntities>::get(const size_t id) -> Comp&
+auto Components<Comps...>::owners() -> std::vector<size_t> const&
 {
-    return component<Comp>()->vec()[id];
+    return component<Comp>().owners();
 }
 
-template <size_t MaxEntities>
+// adds the component to the id's signature and marks it as changed if it does not have it yet
+template <typename... Comps>
 template <typename Comp>
-auto Components<MaxEntities>::component() -> Component<MaxEntities, Comp>*
+auto Components<Comps...>::add(const size_t id) -> Comp&
+{
+    auto& signature{ m_signatures[id] };
+    constexpr auto bit{ sl::index_of<Comp, Comps...>() };
+    if (!signature[bit])
+    {
+        signature.set(bit);
+        signature_changed(id, Signature{}.set(bit));
+        component<Comp>().mark_changed(id);
+    }
+
+    return component<Comp>().add(id);
+}
+
+// the id must have the component, which is checked in debug builds
+template <typename... Comps>
+template <typename Comp>
+auto Components<Comps...>::get(const size_t id) -> Comp&
+{
+    check_contains<Comp>(id);
+
+    return component<Comp>().get(id);
+}
+
+template <typename... Comps>
+template <typename Comp>
+auto Components<Comps...>::get(const size_t id) const -> Comp const&
+{
+    check_contains<Comp>(id);
+
+    return component<Comp>().get(id);
+}
+
+// for components an id may not have, returns nullptr if it doesn't
+template <typename... Comps>
+template <typename Comp>
+auto Components<Comps...>::try_get(const size_t id) -> Comp*
+{
+    return contains<Comp>(id) ? &component<Comp>().get(id) : nullptr;
+}
+
+template <typename... Comps>
+template <typename Comp>
+auto Components<Comps...>::try_get(const size_t id) const -> Comp const*
+{
+    return contains<Comp>(id) ? &component<Comp>().get(id) : nullptr;
+}
+
+template <typename... Comps>
+template <typename Comp>
+auto Components<Comps...>::contains(const size_t id) const -> bool
+{
+    return m_signatures[id][sl::index_of<Comp, Comps...>()];
+}
+
+// sets each of comps on every id, adding them to the signatures in a single pass and marking them all as changed
+template <typename... Comps>
+template <typename... Cs>
+auto Components<Comps...>::insert(const std::span<const size_t> ids, Cs const&... comps) -> void
+{
+    Signature added;
+    (added.set(sl::index_of<Cs, Comps...>()), ...);
+    for (const auto id : ids)
+    {
+        auto& signature{ m_signatures[id] };
+        const auto gained{ added & ~signature };
+        if (gained.any())
+        {
+            signature |= added;
+            signature_changed(id, gained);
+        }
+    }
+
+    const auto insert_comp{ [&]<typename Comp>(Comp const& comp)
+                            {
+                                auto& storage{ component<Comp>() };
+                                for (const auto id : ids)
+                                {
+                                    storage.add(id) = comp;
+                                    storage.mark_changed(id);
+                                }
+                            } };
+    (insert_comp(comps), ...);
+}
+
+// ids having all of Cs, in ascending order
+// the returned vector is only rebuilt by later calls, so components can be added or removed while iterating it
+template <typename... Comps>
+template <typename... Cs>
+auto Components<Comps...>::ids() -> std::vector<size_t> const&
+{
+    Signature required;
+    (required.set(sl::index_of<Cs, Comps...>()), ...);
+    const std::scoped_lock lock{ m_views_mutex };
+    auto& cache{ m_views[required] };
+    update_view(required, cache);
+
+    return cache.ids;
+}
+
+// yields (id, Cs&...) tuples for the ids having all of Cs
+template <typename... Comps>
+template <typename... Cs>
+auto Components<Comps...>::view()
+{
+    return ids<Cs...>()
+        | std::views::transform([this](const size_t id)
+                                { return std::tuple<size_t, Cs&...>{ id, component<Cs>().get(id)... }; });
+}
+
+// calls func(id, Cs&...) for the ids having all of Cs, split into chunks of ids which run in parallel on the pool
+// func runs on several threads at once, so it must only touch the components it is given and must not add or remove
+// components
+template <typename... Comps>
+template <typename... Cs, typename Func>
+auto Components<Comps...>::par_each(sj::Pool& pool, const size_t chunk_size, Func&& func) -> void
+{
+    auto const& ids{ this->ids<Cs...>() };
+    pool.parallel_for(
+        0,
+        ids.size(),
+        chunk_size,
+        [&](const size_t first, const size_t last)
+        {
+            for (auto i{ first }; i < last; i++)
+            {
+                const auto id{ ids[i] };
+                func(id, component<Cs>().get(id)...);
+            }
+        }
+    );
+}
+
+// as above, but func returns whether to defer the id, such as to mark a component changed or destroy the entity
+// deferred(id) is called on the calling thread once every chunk is done, in ascending id order regardless of how the
+// chunks were scheduled
+template <typename... Comps>
+template <typename... Cs, typename Func, typename Deferred>
+auto Components<Comps...>::par_each(sj::Pool& pool, const size_t chunk_size, Func&& func, Deferred&& deferred)
+    -> void
+{
+    auto const& ids{ this->ids<Cs...>() };
+    const auto step{ std::max(chunk_size, size_t{ 1 }) };
+    auto chunk_deferred{ take_deferred((ids.size() + step - 1) / step, step) };
+    pool.parallel_for(
+        0,
+        ids.size(),
+        step,
+        [&](const size_t first, const size_t last)
+        {
+            auto& deferred_ids{ chunk_deferred[first / step] };
+            for (auto i{ first }; i < last; i++)
+            {
+                const auto id{ ids[i] };
+                if (func(id, component<Cs>().get(id)...))
+                {
+                    deferred_ids.push_back(id);
+                }
+            }
+        }
+    );
+
+    for (auto const& deferred_ids : chunk_deferred)
+    {
+        for (const auto id : deferred_ids)
+        {
+            deferred(id);
+        }
+    }
+
+    return_deferred(std::move(chunk_deferred));
+}
+
+template <typename... Comps>
+template <typename Comp>
+auto Components<Comps...>::track() -> size_t
+{
+    return component<Comp>().track();
+}
+
+template <typename... Comps>
+template <typename Comp>
+auto Components<Comps...>::mark_changed(const size_t id) -> void
+{
+    component<Comp>().mark_changed(id);
+}
+
+// skips ids which have since lost the component, such as destroyed entities
+template <typename... Comps>
+template <typename Comp, typename Func>
+auto Components<Comps...>::drain_changed(const size_t tracker, Func&& func) -> void
+{
+    component<Comp>().drain_changed(
+        tracker,
+        [this, &func](const size_t id)
+        {
+            if (contains<Comp>(id))
+            {
+                func(id);
+            }
+        }
+    );
+}
+
+template <typename... Comps>
+auto Components<Comps...>::save(snapshot::Writer& writer) const -> void
+{
+    writer.write(m_signatures);
+    std::apply([&writer](auto const&... components) { (components.save(writer), ...); }, m_components);
+}
+
+// takes the entity types read from the same snapshot, ids of type 0 being free
+// signatures have to cover every entity, free ids can't have components, and an id can only have a sparse component
+// if it has somewhere to store it
+// nothing is changed, the components are only replaced by passing what is returned to load
+template <typename... Comps>
+template <sl::Enumerable Entity>
+auto Components<Comps...>::read(snapshot::Reader& reader, const std::span<const Entity> entities) const -> Sections
+{
+    const auto capacity{ entities.size() };
+    const Sections sections{
+        .signatures = reader.read<Signature>(),
+        .components = { component<Comps>().read(reader, capacity)... },
+    };
+    if (reader.ok() && sections.signatures.size() != capacity)
+    {
+        reader.fail("the component signatures don't match the entities");
+    }
+
+    auto free_has_components{ false };
+    for (size_t id{ 0 }; reader.ok() && id < capacity && !free_has_components; id++)
+    {
+        free_has_components = entities[id] == static_cast<Entity>(0) && sections.signatures[id].any();
+    }
+
+    if (free_has_components)
+    {
+        reader.fail("a free entity has components");
+    }
+
+    // dense storage loads without a sparse section, and holds a component for every id
+    const auto stored{ [&sections, capacity]<typename Comp>(std::type_identity<Comp>)
+                       {
+                           constexpr auto bit{ sl::index_of<Comp, Comps...>() };
+                           auto const& [vec, sparse, owners]{ std::get<bit>(sections.components) };
+                           for (size_t id{ 0 }; id < capacity && !sparse.empty(); id++)
+                           {
+                               if (sections.signatures[id][bit] && sparse[id] >= vec.size())
+                               {
+                                   return false;
+                               }
+                           }
+
+                           return true;
+                       } };
+    if (reader.ok() && !(stored(std::type_identity<Comps>{}) && ...))
+    {
+        reader.fail("a signature has a component which isn't stored");
+    }
+
+    return sections;
+}
+
+// sections must have been returned by read from a reader which is still ok
+// views are rebuilt on their next use, and every component loaded is marked changed, so systems tracking changes
+// revisit every entity once
+template <typename... Comps>
+auto Components<Comps...>::load(Sections const& sections) -> void
+{
+    m_signatures.assign(sections.signatures);
+    const auto capacity{ m_signatures.size() };
+    (component<Comps>().load(std::get<sl::index_of<Comps, Comps...>()>(sections.components), capacity), ...);
+    rebuild_views();
+    const auto mark_all{ [this]<typename Comp>(Component<Comp>& comp)
+                         {
+                             constexpr auto bit{ sl::index_of<Comp, Comps...>() };
+                             for (size_t id{ 0 }; id < m_signatures.size(); id++)
+                             {
+                                 if (m_signatures[id][bit])
+                                 {
+                                     comp.mark_changed(id);
+                                 }
+                             }
+                         } };
+    (mark_all(component<Comps>()), ...);
+}
+
+// queues the id on every view requiring one of the bits which changed, signatures are only changed by systems which
+// write them, so no view is being read at the same time
+// a view which isn't used for a while stops queueing once it has seen as many changes as there are ids, and is rebuilt
+// instead
+template <typename... Comps>
+auto Components<Comps...>::signature_changed(const size_t id, const Signature bits) -> void
+{
+    for (auto& [required, cache] : m_views)
+    {
+        if (cache.rebuild || (bits & required).none())
+        {
+            continue;
+        }
+
+        if (cache.changed.size() >= m_signatures.size())
+        {
+            cache.rebuild = true;
+            cache.changed.clear();
+            continue;
+        }
+
+        cache.changed.push_back(id);
+    }
+}
+
+template <typename... Comps>
+auto Components<Comps...>::rebuild_views() -> void
+{
+    for (auto& [required, cache] : m_views)
+    {
+        cache.rebuild = true;
+        cache.changed.clear();
+    }
+}
+
+// costs the number of ids in the view plus the number changed, the changed ids are dropped from the view and merged
+// back in if they still match, keeping the ids ascending
+template <typename... Comps>
+auto Components<Comps...>::update_view(const Signature required, ViewCache& cache) -> void
+{
+    const auto matches{ [this, required](const size_t id) { return (m_signatures[id] & required) == required; } };
+    if (cache.rebuild)
+    {
+        cache.ids.clear();
+        for (size_t id{ 0 }; id < m_signatures.size(); id++)
+        {
+            if (matches(id))
+            {
+                cache.ids.push_back(id);
+            }
+        }
+
+        cache.rebuild = false;
+        cache.changed.clear();
+        return;
+    }
+
+    if (cache.changed.empty())
+    {
+        return;
+    }
+
+    auto& changed{ cache.changed };
+    std::ranges::sort(changed);
+    changed.erase(std::ranges::unique(changed).begin(), changed.end());
+    auto& merged{ cache.merged };
+    merged.clear();
+    auto next_changed{ changed.begin() };
+    const auto merge_changed_below{ [&](const size_t id)
+                                    {
+                                        for (; next_changed != changed.end() && *next_changed < id; next_changed++)
+                                        {
+                                            if (matches(*next_changed))
+                                            {
+                                                merged.push_back(*next_changed);
+                                            }
+                                        }
+                                    } };
+    for (const auto id : cache.ids)
+    {
+        merge_changed_below(id);
+        if (next_changed != changed.end() && *next_changed == id)
+        {
+            next_changed++;
+            if (!matches(id))
+            {
+                continue;
+            }
+        }
+
+        merged.push_back(id);
+    }
+
+    merge_changed_below(std::numeric_limits<size_t>::max());
+    std::swap(cache.ids, merged);
+    changed.clear();
+}
+
+// fails to compile if Comp is not one of Comps
+template <typename... Comps>
+template <typename Comp>
+auto Components<Comps...>::component() -> Component<Comp>&
+{
+    return std::get<Component<Comp>>(m_components);
+}
+
+template <typename... Comps>
+template <typename Comp>
+auto Components<Comps...>::component() const -> Component<Comp> const&
+{
+    return std::get<Component<Comp>>(m_components);
+}
+
+template <typename... Comps>
+template <typename Comp>
+auto Components<Comps...>::check_contains([[maybe_unused]] const size_t id) const -> void
 {
 #ifndef NDEBUG
-    if (!m_components.contains(typeid(Comp).hash_code()))
+    if (!contains<Comp>(id))
     {
-        slog::log(slog::FTL, "Components map does not contain component {}", typeid(Comp).name());
+        slog::log(slog::FTL, "Entity {} does not have component {}", id, typeid(Comp).name());
     }
 #endif
+}
+
+// an empty list per chunk with room for every id in the chunk, so deferring never grows a list part way through
+// sets are never shrunk, the lists past the last chunk staying empty, so this only allocates when there are more or
+// larger chunks than any set handed back so far
+template <typename... Comps>
+auto Components<Comps...>::take_deferred(const size_t chunks, const size_t chunk_size)
+    -> std::vector<std::vector<size_t>>
+{
+    std::vector<std::vector<size_t>> chunk_deferred;
+    {
+        const std::scoped_lock lock{ m_deferred_mutex };
+        if (!m_deferred.empty())
+        {
+            chunk_deferred = std::move(m_deferred.back());
+            m_deferred.pop_back();
+        }
+    }
+
+    chunk_deferred.resize(std::max(chunks, chunk_deferred.size()));
+    for (auto& deferred_ids : chunk_deferred)
+    {
+        deferred_ids.clear();
+        deferred_ids.reserve(chunk_size);
+    }
+
+    return chunk_deferred;
+}
 
-    return dynamic_cast<Component<MaxEntities, Comp>*>(m_components[typeid(Comp).hash_code()].get());
+template <typename... Comps>
+auto Components<Comps...>::return_deferred(std::vector<std::vector<size_t>> chunk_deferred) -> void
+{
+    const std::scoped_lock lock{ m_deferred_mutex };
+    m_deferred.push_back(std::move(chunk_deferred));
+}
+
+template <typename... Comps>
+template <typename Comp>
+auto EntityComponents<Comps...>::add() -> Comp&
+{
+    return m_components->template add<Comp>(m_id);
+}
+
+template <typename... Comps>
+template <typename Comp>
+auto EntityComponents<Comps...>::get() -> Comp&
+{
+    return m_components->template get<Comp>(m_id);
 }
 
-template <size_t MaxEntities>
+template <typename... Comps>
 template <typename Comp>
-auto EntityComponents<MaxEntities>::get() -> Comp&
+auto EntityComponents<Comps...>::try_get() -> Comp*
 {
-    return m_components->template component<Comp>()->vec()[m_id];
+    return m_components->template try_get<Comp>(m_id);
 }
 
-template <size_t MaxEntities>
-EntityComponents<MaxEntities>::EntityComponents(Components<MaxEntities>& components, const size_t id)
+template <typename... Comps>
+EntityComponents<Comps...>::EntityComponents(Components<Comps...>& components, const size_t id)
     : m_components{ &components }
     , m_id{ id }
 {
@@ -1,30 +1,84 @@
 #ifndef SE_ENTITIES_HPP_
 #define SE_ENTITIES_HPP_
 
+#include "se-paged.hpp"
+#include "se-snapshot.hpp"
 #include "seblib.hpp"
 #include "sl-log.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
-#include <ranges>
-#include <unordered_map>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace seb_engine
 {
 namespace sl = seblib;
 
-// assumes Entity has a "no entity" value of 0
-template <size_t MaxEntities, sl::Enumerable Entity>
+// returned in place of an id when an entity can't be spawned
+inline constexpr auto NO_ENTITY{ std::numeric_limits<size_t>::max() };
+
+// id + generation pair, used to detect ids that refer to a slot which has since been recycled
+struct EntityHandle
+{
+    size_t id{ 0 };
+    uint32_t generation{ 0 };
+
+    [[nodiscard]] auto operator==(EntityHandle const& handle) const -> bool = default;
+};
+
+// assumes Entity has a "no entity" value of 0, and a one byte underlying type so every type can index an array
+// storage grows a page at a time up to the maximum given on construction, anything else indexed by id should be grown
+// to capacity() after spawning
+template <sl::Enumerable Entity>
 class Entities
 {
 public:
+    // the snapshot sections holding the entity table, viewed in place in the reader's mapping
+    struct Sections
+    {
+        std::span<const Entity> entities;
+        std::span<const uint32_t> generations;
+        std::span<const size_t> type_indices;
+        std::span<const size_t> free_ids;
+        std::span<const size_t> counts;
+        std::span<const size_t> ids;
+    };
+
+    explicit Entities(size_t max_entities = NO_ENTITY);
+
     [[nodiscard]] auto spawn(Entity type) -> size_t;
-    [[nodiscard]] auto vec() const -> std::vector<Entity> const&;
-    [[nodiscard]] auto ids(Entity entity) -> std::vector<size_t> const&;
+    [[nodiscard]] auto spawn_batch(Entity type, size_t count) -> std::vector<size_t>;
+    auto spawn_batch(Entity type, size_t count, std::vector<size_t>& ids) -> void;
+    [[nodiscard]] auto capacity() const -> size_t;
+    [[nodiscard]] auto vec() const -> Paged<Entity> const&;
+    [[nodiscard]] auto ids(Entity entity) const -> std::vector<size_t> const&;
+    [[nodiscard]] auto handle(size_t id) const -> EntityHandle;
+    [[nodiscard]] auto valid(EntityHandle handle) const -> bool;
     auto destroy(size_t id) -> void;
+    auto save(snapshot::Writer& writer) const -> void;
+    [[nodiscard]] auto read(snapshot::Reader& reader) const -> Sections;
+    auto load(Sections const& sections) -> void;
 
 private:
-    std::vector<Entity> m_entities{ MaxEntities, static_cast<Entity>(0) };
-    std::unordered_map<Entity, std::vector<size_t>> m_entity_ids;
+    static_assert(sizeof(std::underlying_type_t<Entity>) == 1);
+    static constexpr size_t ENTITY_TYPES{ 256 };
+
+    size_t m_max_entities;
+    Paged<Entity> m_entities;
+    Paged<uint32_t> m_generations;
+    std::vector<size_t> m_free_ids;
+    std::array<std::vector<size_t>, ENTITY_TYPES> m_entity_ids;
+    // position of each id within its type's entry in m_entity_ids
+    Paged<size_t> m_type_indices;
+
+    auto grow() -> void;
+    [[nodiscard]] auto consistent(Sections const& sections) const -> bool;
 };
 } // namespace seb_engine
 
@@ -38,47 +92,119 @@ namespace seb_engine
 {
 namespace slog = seblib::log;
 
-template <size_t MaxEntities, sl::Enumerable Entity>
-auto Entities<MaxEntities, Entity>::spawn(const Entity type) -> size_t
+template <sl::Enumerable Entity>
+Entities<Entity>::Entities(const size_t max_entities)
+    : m_max_entities{ max_entities }
 {
-    size_t entity_id{ 0 };
-    for (const auto [id, entity] : m_entities | std::views::enumerate)
-    {
-        if (entity != static_cast<Entity>(0))
-        {
-            continue;
-        }
+}
 
-        entity = type;
-        entity_id = id;
-        m_entity_ids[type].push_back(entity_id);
-        break;
+// returns NO_ENTITY if the maximum number of entities are alive
+template <sl::Enumerable Entity>
+auto Entities<Entity>::spawn(const Entity type) -> size_t
+{
+    if (m_free_ids.empty())
+    {
+        grow();
     }
 
-    slog::log(slog::TRC, "Spawning entity type {} with id {}", static_cast<int>(type), entity_id);
-    if (entity_id == MaxEntities)
+    if (m_free_ids.empty())
     {
         slog::log(slog::WRN, "Maximum entities reached");
+
+        return NO_ENTITY;
     }
 
+    const auto entity_id{ m_free_ids.back() };
+    m_free_ids.pop_back();
+    m_entities[entity_id] = type;
+    auto& entity_ids{ m_entity_ids[std::to_underlying(type)] };
+    m_type_indices[entity_id] = entity_ids.size();
+    entity_ids.push_back(entity_id);
+    slog::log(slog::TRC, "Spawning entity type {} with id {}", static_cast<int>(type), entity_id);
+
     return entity_id;
 }
 
-template <size_t MaxEntities, sl::Enumerable Entity>
-auto Entities<MaxEntities, Entity>::vec() const -> std::vector<Entity> const&
+// returns fewer than count ids if the maximum number of entities is reached part way through
+template <sl::Enumerable Entity>
+auto Entities<Entity>::spawn_batch(const Entity type, const size_t count) -> std::vector<size_t>
+{
+    std::vector<size_t> ids;
+    spawn_batch(type, count, ids);
+
+    return ids;
+}
+
+// as above, but replaces the contents of ids, so a vector kept between batches stops allocating once it has grown
+template <sl::Enumerable Entity>
+auto Entities<Entity>::spawn_batch(const Entity type, const size_t count, std::vector<size_t>& ids) -> void
+{
+    ids.clear();
+    ids.reserve(count);
+    auto& entity_ids{ m_entity_ids[std::to_underlying(type)] };
+    while (ids.size() < count)
+    {
+        if (m_free_ids.empty())
+        {
+            grow();
+        }
+
+        if (m_free_ids.empty())
+        {
+            slog::log(slog::WRN, "Maximum entities reached");
+            break;
+        }
+
+        const auto batch_size{ std::min(count - ids.size(), m_free_ids.size()) };
+        for (size_t i{ 0 }; i < batch_size; i++)
+        {
+            const auto entity_id{ m_free_ids.back() };
+            m_free_ids.pop_back();
+            m_entities[entity_id] = type;
+            m_type_indices[entity_id] = entity_ids.size();
+            entity_ids.push_back(entity_id);
+            ids.push_back(entity_id);
+        }
+    }
+
+    slog::log(slog::TRC, "Spawning {} entities of type {}", ids.size(), static_cast<int>(type));
+}
+
+template <sl::Enumerable Entity>
+auto Entities<Entity>::capacity() const -> size_t
+{
+    return m_entities.size();
+}
+
+template <sl::Enumerable Entity>
+auto Entities<Entity>::vec() const -> Paged<Entity> const&
 {
     return m_entities;
 }
 
-// not marked const to allow creating vector for key if it doesn't exist already
-template <size_t MaxEntities, sl::Enumerable Entity>
-auto Entities<MaxEntities, Entity>::ids(const Entity entity) -> std::vector<size_t> const&
+// destroying an entity moves the last entity of the same type into its place, so ids are not kept in spawn order
+template <sl::Enumerable Entity>
+auto Entities<Entity>::ids(const Entity entity) const -> std::vector<size_t> const&
+{
+    return m_entity_ids[std::to_underlying(entity)];
+}
+
+template <sl::Enumerable Entity>
+auto Entities<Entity>::handle(const size_t id) const -> EntityHandle
+{
+    return { .id = id, .generation = m_generations[id] };
+}
+
+template <sl::Enumerable Entity>
+auto Entities<Entity>::valid(const EntityHandle handle) const -> bool
 {
-    return m_entity_ids[entity];
+    return handle.id < m_entities.size()
+        && m_generations[handle.id] == handle.generation
+        && m_entities[handle.id] != static_cast<Entity>(0);
 }
 
-template <size_t MaxEntities, sl::Enumerable Entity>
-auto Entities<MaxEntities, Entity>::destroy(const size_t id) -> void
+template <sl::Enumerable Entity>
+auto Entities<Entity>::destroy(const size_t id) -> void
 {
     auto& entity{ m_entities[id] };
     // possible for an entity to be queued for destruction multiple times
@@ -88,9 +214,148 @@ auto Entities<MaxEntities, Entity>::destroy(const size_t id) -> void
     }
 
     slog::log(slog::TRC, "Destroying entity type {} with id {}", static_cast<int>(entity), id);
-    auto& entity_ids{ m_entity_ids[entity] };
-    entity_ids.erase(std::ranges::find(entity_ids, id));
+    auto& entity_ids{ m_entity_ids[std::to_underlying(entity)] };
+    const auto type_index{ m_type_indices[id] };
+    const auto last_id{ entity_ids.back() };
+    entity_ids[type_index] = last_id;
+    m_type_indices[last_id] = type_index;
+    entity_ids.pop_back();
     entity = static_cast<Entity>(0);
+    m_generations[id]++;
+    m_free_ids.push_back(id);
+}
+
+// the free list and the order of each type's ids are kept, so a loaded game spawns and iterates entities exactly as the
+// saved one would have
+template <sl::Enumerable Entity>
+auto Entities<Entity>::save(snapshot::Writer& writer) const -> void
+{
+    std::array<size_t, ENTITY_TYPES> counts{};
+    std::vector<size_t> ids;
+    for (size_t type{ 0 }; type < ENTITY_TYPES; type++)
+    {
+        counts[type] = m_entity_ids[type].size();
+        ids.insert(ids.end(), m_entity_ids[type].begin(), m_entity_ids[type].end());
+    }
+
+    writer.write(m_entities);
+    writer.write(m_generations);
+    writer.write(m_type_indices);
+    writer.write(std::span<const size_t>{ m_free_ids });
+    writer.write(std::span<const size_t>{ counts });
+    writer.write(std::span<const size_t>{ ids });
+}
+
+// reads and checks the entity table without touching the current one, which load then replaces
+template <sl::Enumerable Entity>
+auto Entities<Entity>::read(snapshot::Reader& reader) const -> Sections
+{
+    const Sections sections{
+        .entities = reader.read<Entity>(),
+        .generations = reader.read<uint32_t>(),
+        .type_indices = reader.read<size_t>(),
+        .free_ids = reader.read<size_t>(),
+        .counts = reader.read<size_t>(),
+        .ids = reader.read<size_t>(),
+    };
+    if (reader.ok() && !consistent(sections))
+    {
+        reader.fail("the entity table is inconsistent");
+    }
+
+    return sections;
+}
+
+// sections must have been returned by read from a reader which is still ok
+template <sl::Enumerable Entity>
+auto Entities<Entity>::load(Sections const& sections) -> void
+{
+    m_entities.assign(sections.entities);
+    m_generations.assign(sections.generations);
+    m_type_indices.assign(sections.type_indices);
+    m_free_ids.assign(sections.free_ids.begin(), sections.free_ids.end());
+    auto remaining{ sections.ids };
+    for (size_t type{ 0 }; type < ENTITY_TYPES; type++)
+    {
+        const auto type_ids{ remaining.first(sections.counts[type]) };
+        m_entity_ids[type].assign(type_ids.begin(), type_ids.end());
+        remaining = remaining.subspan(sections.counts[type]);
+    }
+}
+
+// free ids are handed out from the back, so push in reverse to spawn the lowest ids first
+template <sl::Enumerable Entity>
+auto Entities<Entity>::grow() -> void
+{
+    const auto capacity{ m_entities.size() };
+    const auto new_capacity{ std::min(capacity + PAGE_SIZE, m_max_entities) };
+    if (new_capacity == capacity)
+    {
+        return;
+    }
+
+    slog::log(slog::INF, "Growing entity capacity to {}", new_capacity);
+    m_entities.resize(new_capacity, static_cast<Entity>(0));
+    m_generations.resize(new_capacity, 0);
+    m_type_indices.resize(new_capacity, 0);
+    for (auto id{ new_capacity }; id > capacity; id--)
+    {
+        m_free_ids.push_back(id - 1);
+    }
+}
+
+// every id has to be exactly one of free with no type, or live at its type index in its type's ids
+template <sl::Enumerable Entity>
+auto Entities<Entity>::consistent(Sections const& sections) const -> bool
+{
+    const auto capacity{ sections.entities.size() };
+    if (capacity > m_max_entities
+        || sections.generations.size() != capacity
+        || sections.type_indices.size() != capacity
+        || sections.counts.size() != ENTITY_TYPES
+        || sections.counts.front() != 0
+        || sections.free_ids.size() + sections.ids.size() != capacity)
+    {
+        return false;
+    }
+
+    std::vector<bool> seen(capacity, false);
+    for (const auto id : sections.free_ids)
+    {
+        if (id >= capacity || seen[id] || sections.entities[id] != static_cast<Entity>(0))
+        {
+            return false;
+        }
+
+        seen[id] = true;
+    }
+
+    auto remaining{ sections.ids };
+    for (size_t type{ 0 }; type < ENTITY_TYPES; type++)
+    {
+        if (sections.counts[type] > remaining.size())
+        {
+            return false;
+        }
+
+        const auto type_ids{ remaining.first(sections.counts[type]) };
+        remaining = remaining.subspan(sections.counts[type]);
+        for (size_t index{ 0 }; index < type_ids.size(); index++)
+        {
+            const auto id{ type_ids[index] };
+            if (id >= capacity
+                || seen[id]
+                || std::to_underlying(sections.entities[id]) != type
+                || sections.type_indices[id] != index)
+            {
+                return false;
+            }
+
+            seen[id] = true;
+        }
+    }
+
+    return true;
 }
 } // namespace seb_engine
 
@@ -0,0 +1,132 @@
+#ifndef SE_HIERARCHY_HPP_
+#define SE_HIERARCHY_HPP_
+
+#include "se-entities.hpp"
+#include "se-paged.hpp"
+#include "se-snapshot.hpp"
+#include "seblib.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace seb_engine
+{
+// parent/child links stored as first child/next sibling lists, so attaching and detaching an entity is constant time
+// and walking or destroying a subtree only touches the entities in it
+// storage must be grown with resize to cover every id before it is used
+class Hierarchy
+{
+    struct Links;
+
+public:
+    // the snapshot section holding the links, viewed in place in the reader's mapping
+    struct Sections
+    {
+        std::span<const Links> links;
+    };
+
+    auto resize(size_t capacity) -> void;
+    auto attach(size_t child, size_t parent) -> void;
+    auto detach(size_t id) -> void;
+    [[nodiscard]] auto parent(size_t id) const -> std::optional<size_t>;
+    template <typename Func>
+    auto each_child(size_t id, Func&& func) const -> void;
+    template <typename Func>
+    auto destroy(size_t id, Func&& func) -> void;
+    auto save(snapshot::Writer& writer) const -> void;
+    template <sl::Enumerable Entity>
+    [[nodiscard]] auto read(snapshot::Reader& reader, std::span<const Entity> entities) const -> Sections;
+    auto load(Sections const& sections) -> void;
+
+private:
+    struct Links
+    {
+        size_t parent{ NO_ENTITY };
+        size_t first_child{ NO_ENTITY };
+        size_t next_sibling{ NO_ENTITY };
+        size_t prev_sibling{ NO_ENTITY };
+
+        auto operator==(Links const&) const -> bool = default;
+    };
+
+    Paged<Links> m_links;
+
+    [[nodiscard]] auto read(snapshot::Reader& reader, std::vector<bool> const& live) const -> Sections;
+    [[nodiscard]] static auto consistent(std::span<const Links> links, std::vector<bool> const& live) -> bool;
+};
+} // namespace seb_engine
+
+/****************************
+ *                          *
+ * TEMPLATE IMPLEMENTATIONS *
+ *                          *
+ ****************************/
+
+namespace seb_engine
+{
+// takes the entity types read from the same snapshot, ids of type 0 being free
+// nothing is changed, the links are only replaced by passing what is returned to load
+template <sl::Enumerable Entity>
+auto Hierarchy::read(snapshot::Reader& reader, const std::span<const Entity> entities) const -> Sections
+{
+    std::vector<bool> live(entities.size(), false);
+    for (size_t id{ 0 }; id < entities.size(); id++)
+    {
+        live[id] = entities[id] != static_cast<Entity>(0);
+    }
+
+    return read(reader, live);
+}
+
+// calls func(child_id) for each direct child, most recently attached first
+template <typename Func>
+auto Hierarchy::each_child(const size_t id, Func&& func) const -> void
+{
+    for (auto child{ m_links[id].first_child }; child != NO_ENTITY; child = m_links[child].next_sibling)
+    {
+        func(child);
+    }
+}
+
+// detaches the entity and calls func(id) for it and every entity below it, children before their parents
+// each entity is unlinked before func is called on it, so func can safely destroy the entity
+template <typename Func>
+auto Hierarchy::destroy(const size_t id, Func&& func) -> void
+{
+    detach(id);
+    auto node{ id };
+    while (true)
+    {
+        while (m_links[node].first_child != NO_ENTITY)
+        {
+            node = m_links[node].first_child;
+        }
+
+        // node has no children left, and below the root is always its parent's first child
+        const auto parent{ m_links[node].parent };
+        const auto is_root{ node == id };
+        if (!is_root)
+        {
+            const auto next_sibling{ m_links[node].next_sibling };
+            m_links[parent].first_child = next_sibling;
+            if (next_sibling != NO_ENTITY)
+            {
+                m_links[next_sibling].prev_sibling = NO_ENTITY;
+            }
+        }
+
+        m_links[node] = {};
+        func(node);
+        if (is_root)
+        {
+            return;
+        }
+
+        node = parent;
+    }
+}
+} // namespace seb_engine
+
+#endif
@@ -0,0 +1,407 @@
+#ifndef SE_PAGED_HPP_
+#define SE_PAGED_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace seb_engine
+{
+inline constexpr size_t PAGE_SIZE{ 1024 };
+
+// vector-like storage split into fixed size pages, so growing never moves existing elements and references to them stay
+// valid until the element itself is removed
+// the page size is a power of two, so indexing costs a shift and a mask on top of a vector lookup
+template <typename T, size_t PageSize = PAGE_SIZE>
+class Paged
+{
+    template <bool Const>
+    class Iterator;
+
+public:
+    using value_type = T;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    [[nodiscard]] auto operator[](size_t index) -> T&;
+    [[nodiscard]] auto operator[](size_t index) const -> T const&;
+    [[nodiscard]] auto size() const -> size_t;
+    [[nodiscard]] auto empty() const -> bool;
+    [[nodiscard]] auto back() -> T&;
+    [[nodiscard]] auto page_count() const -> size_t;
+    [[nodiscard]] auto page(size_t page) -> std::span<T>;
+    [[nodiscard]] auto page(size_t page) const -> std::span<T const>;
+    auto resize(size_t size, T const& value = T{}) -> void;
+    auto assign(std::span<const T> values) -> void;
+    template <typename... Args>
+    auto emplace_back(Args&&... args) -> T&;
+    auto push_back(T value) -> void;
+    auto pop_back() -> void;
+    [[nodiscard]] auto begin() -> iterator;
+    [[nodiscard]] auto end() -> iterator;
+    [[nodiscard]] auto begin() const -> const_iterator;
+    [[nodiscard]] auto end() const -> const_iterator;
+
+private:
+    static_assert(std::has_single_bit(PageSize));
+    static constexpr auto PAGE_SHIFT{ std::countr_zero(PageSize) };
+    static constexpr auto PAGE_MASK{ PageSize - 1 };
+
+    using Page = std::array<T, PageSize>;
+
+    std::vector<std::unique_ptr<Page>> m_pages;
+    size_t m_size{ 0 };
+
+    auto reserve_pages(size_t size) -> void;
+};
+
+template <typename T, size_t PageSize>
+template <bool Const>
+class Paged<T, PageSize>::Iterator
+{
+public:
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using Pages = std::conditional_t<Const, Paged const, Paged>;
+
+    Iterator() = default;
+    Iterator(Pages* paged, size_t index);
+
+    [[nodiscard]] auto operator*() const -> std::conditional_t<Const, T const&, T&>;
+    [[nodiscard]] auto operator[](difference_type offset) const -> std::conditional_t<Const, T const&, T&>;
+    auto operator++() -> Iterator&;
+    auto operator++(int) -> Iterator;
+    auto operator--() -> Iterator&;
+    auto operator--(int) -> Iterator;
+    auto operator+=(difference_type offset) -> Iterator&;
+    auto operator-=(difference_type offset) -> Iterator&;
+    [[nodiscard]] auto operator+(difference_type offset) const -> Iterator;
+    [[nodiscard]] auto operator-(difference_type offset) const -> Iterator;
+    [[nodiscard]] auto operator-(Iterator const& iterator) const -> difference_type;
+    [[nodiscard]] auto operator==(Iterator const& iterator) const -> bool;
+    [[nodiscard]] auto operator<=>(Iterator const& iterator) const -> std::strong_ordering;
+
+    [[nodiscard]] friend auto operator+(const difference_type offset, Iterator const& iterator) -> Iterator
+    {
+        return iterator + offset;
+    }
+
+private:
+    using Element = std::conditional_t<Const, T const, T>;
+
+    Pages* m_paged{ nullptr };
+    size_t m_index{ 0 };
+    // cached so stepping within a page is a pointer increment
+    Element* m_element{ nullptr };
+
+    auto locate() -> void;
+};
+} // namespace seb_engine
+
+/****************************
+ *                          *
+ * TEMPLATE IMPLEMENTATIONS *
+ *                          *
+ ****************************/
+
+namespace seb_engine
+{
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::operator[](const size_t index) -> T&
+{
+    return (*m_pages[index >> PAGE_SHIFT])[index & PAGE_MASK];
+}
+
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::operator[](const size_t index) const -> T const&
+{
+    return (*m_pages[index >> PAGE_SHIFT])[index & PAGE_MASK];
+}
+
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::size() const -> size_t
+{
+    return m_size;
+}
+
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::empty() const -> bool
+{
+    return m_size == 0;
+}
+
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::back() -> T&
+{
+    return (*this)[m_size - 1];
+}
+
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::page_count() const -> size_t
+{
+    return (m_size + PAGE_MASK) >> PAGE_SHIFT;
+}
+
+// the elements of a page as a contiguous span, so loops over every element can run a page at a time instead of paying
+// for the page lookup on each element
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::page(const size_t page) -> std::span<T>
+{
+    return { m_pages[page]->data(), std::min(PageSize, m_size - (page << PAGE_SHIFT)) };
+}
+
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::page(const size_t page) const -> std::span<T const>
+{
+    return { m_pages[page]->data(), std::min(PageSize, m_size - (page << PAGE_SHIFT)) };
+}
+
+// pages are kept when shrinking, removed elements are reset to a default constructed value
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::resize(const size_t size, T const& value) -> void
+{
+    reserve_pages(size);
+    for (auto index{ m_size }; index < size; index++)
+    {
+        (*this)[index] = value;
+    }
+
+    for (auto index{ size }; index < m_size; index++)
+    {
+        (*this)[index] = T{};
+    }
+
+    m_size = size;
+}
+
+// replaces the contents with values, copying a page at a time
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::assign(const std::span<const T> values) -> void
+{
+    const auto old_size{ m_size };
+    reserve_pages(values.size());
+    m_size = values.size();
+    for (size_t page{ 0 }; page < page_count(); page++)
+    {
+        std::ranges::copy(values.subspan(page * PageSize, this->page(page).size()), this->page(page).begin());
+    }
+
+    for (auto index{ m_size }; index < old_size; index++)
+    {
+        (*this)[index] = T{};
+    }
+}
+
+template <typename T, size_t PageSize>
+template <typename... Args>
+auto Paged<T, PageSize>::emplace_back(Args&&... args) -> T&
+{
+    reserve_pages(m_size + 1);
+    auto& element{ (*this)[m_size] };
+    element = T{ std::forward<Args>(args)... };
+    m_size++;
+
+    return element;
+}
+
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::push_back(T value) -> void
+{
+    emplace_back(std::move(value));
+}
+
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::pop_back() -> void
+{
+    back() = T{};
+    m_size--;
+}
+
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::begin() -> iterator
+{
+    return { this, 0 };
+}
+
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::end() -> iterator
+{
+    return { this, m_size };
+}
+
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::begin() const -> const_iterator
+{
+    return { this, 0 };
+}
+
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::end() const -> const_iterator
+{
+    return { this, m_size };
+}
+
+template <typename T, size_t PageSize>
+auto Paged<T, PageSize>::reserve_pages(const size_t size) -> void
+{
+    while (m_pages.size() * PageSize < size)
+    {
+        m_pages.push_back(std::make_unique<Page>());
+    }
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+Paged<T, PageSize>::Iterator<Const>::Iterator(Pages* const paged, const size_t index)
+    : m_paged{ paged }
+    , m_index{ index }
+{
+    locate();
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::operator*() const -> std::conditional_t<Const, T const&, T&>
+{
+    return *m_element;
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::operator[](const difference_type offset) const
+    -> std::conditional_t<Const, T const&, T&>
+{
+    return (*m_paged)[static_cast<size_t>(static_cast<difference_type>(m_index) + offset)];
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::operator++() -> Iterator&
+{
+    m_index++;
+    if ((m_index & PAGE_MASK) == 0)
+    {
+        locate();
+    }
+    else
+    {
+        m_element++;
+    }
+
+    return *this;
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::operator++(int) -> Iterator
+{
+    auto iterator{ *this };
+    ++*this;
+
+    return iterator;
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::operator--() -> Iterator&
+{
+    if ((m_index & PAGE_MASK) == 0)
+    {
+        m_index--;
+        locate();
+    }
+    else
+    {
+        m_index--;
+        m_element--;
+    }
+
+    return *this;
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::operator--(int) -> Iterator
+{
+    auto iterator{ *this };
+    --*this;
+
+    return iterator;
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::operator+=(const difference_type offset) -> Iterator&
+{
+    m_index = static_cast<size_t>(static_cast<difference_type>(m_index) + offset);
+    locate();
+
+    return *this;
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::operator-=(const difference_type offset) -> Iterator&
+{
+    return *this += -offset;
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::operator+(const difference_type offset) const -> Iterator
+{
+    auto iterator{ *this };
+
+    return iterator += offset;
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::operator-(const difference_type offset) const -> Iterator
+{
+    auto iterator{ *this };
+
+    return iterator -= offset;
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::operator-(Iterator const& iterator) const -> difference_type
+{
+    return static_cast<difference_type>(m_index) - static_cast<difference_type>(iterator.m_index);
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::operator==(Iterator const& iterator) const -> bool
+{
+    return m_index == iterator.m_index;
+}
+
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::operator<=>(Iterator const& iterator) const -> std::strong_ordering
+{
+    return m_index <=> iterator.m_index;
+}
+
+// iterators past the last allocated page, such as end(), have no element
+template <typename T, size_t PageSize>
+template <bool Const>
+auto Paged<T, PageSize>::Iterator<Const>::locate() -> void
+{
+    const auto page{ m_index >> PAGE_SHIFT };
+    m_element = (m_paged != nullptr && page < m_paged->m_pages.size()
+                     ? m_paged->m_pages[page]->data() + (m_index & PAGE_MASK)
+                     : nullptr);
+}
+} // namespace seb_engine
+
+#endif
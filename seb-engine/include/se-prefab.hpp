@@ -0,0 +1,65 @@
+#ifndef SE_PREFAB_HPP_
+#define SE_PREFAB_HPP_
+
+#include "seblib.hpp"
+
+#include <cstddef>
+#include <span>
+#include <tuple>
+
+namespace seb_engine
+{
+namespace sl = seblib;
+
+template <sl::Enumerable Entity, typename Comps, typename SpriteParts = std::tuple<>>
+struct Prefab;
+
+// an entity type along with the components and sprite parts every entity spawned from it starts with, so spawning many
+// entities of the same kind writes each component column in one pass rather than entity by entity
+template <sl::Enumerable Entity, typename... Comps, typename... SpriteParts>
+struct Prefab<Entity, std::tuple<Comps...>, std::tuple<SpriteParts...>>
+{
+    Entity type;
+    std::tuple<Comps...> comps;
+    std::tuple<SpriteParts...> sprite_parts;
+
+    template <typename Components, typename Sprites>
+    auto write(std::span<const size_t> ids, Components& components, Sprites& sprites) const -> void;
+};
+
+template <sl::Enumerable Entity, typename... Comps, typename... SpriteParts>
+Prefab(Entity, std::tuple<Comps...>, std::tuple<SpriteParts...>)
+    -> Prefab<Entity, std::tuple<Comps...>, std::tuple<SpriteParts...>>;
+} // namespace seb_engine
+
+/****************************
+ *                          *
+ * TEMPLATE IMPLEMENTATIONS *
+ *                          *
+ ****************************/
+
+namespace seb_engine
+{
+// the ids must already be spawned with storage grown to cover them
+template <sl::Enumerable Entity, typename... Comps, typename... SpriteParts>
+template <typename Components, typename Sprites>
+auto Prefab<Entity, std::tuple<Comps...>, std::tuple<SpriteParts...>>::write(
+    const std::span<const size_t> ids, Components& components, Sprites& sprites
+) const -> void
+{
+    std::apply([&](Comps const&... comp) { components.insert(ids, comp...); }, comps);
+    if constexpr (sizeof...(SpriteParts) > 0)
+    {
+        const auto set_part{ [&]<typename Part>(const Part part)
+                             {
+                                 for (const auto id : ids)
+                                 {
+                                     sprites.set(static_cast<unsigned>(id), part);
+                                 }
+                             } };
+        std::apply([&](SpriteParts const&... part) { (set_part(part), ...); }, sprite_parts);
+    }
+}
+} // namespace seb_engine
+
+#endif
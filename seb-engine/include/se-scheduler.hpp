@@ -0,0 +1,215 @@
+#ifndef SE_SCHEDULER_HPP_
+#define SE_SCHEDULER_HPP_
+
+#include "sl-jobs.hpp"
+#include "sl-log.hpp"
+#include "sl-profile.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ranges>
+#include <string_view>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace seb_engine
+{
+namespace sj = seblib::jobs;
+
+// the components and other state a system reads or writes, identified by type
+template <typename... Ts>
+struct Reads
+{
+    [[nodiscard]] static auto types() -> std::vector<std::type_index>;
+};
+
+template <typename... Ts>
+struct Writes
+{
+    [[nodiscard]] static auto types() -> std::vector<std::type_index>;
+};
+
+// how long a system took to run, the times of systems in the same stage overlap
+struct SystemTime
+{
+    std::string_view name;
+    std::chrono::nanoseconds time{ 0 };
+};
+
+// two systems conflict when either writes something the other reads or writes
+// systems are grouped into stages which run one after another, with the systems in a stage running on separate threads
+// conflicting systems always run in the order they were added, so the results match running every system in order
+// systems are called with the context passed to run, so a scheduler holds no pointers to the state it runs on
+template <typename Context>
+class Scheduler
+{
+public:
+    using System = std::function<void(Context&)>;
+
+    template <typename R, typename W>
+    auto add(std::string_view name, System system) -> void;
+    auto run(Context& context, sj::Pool& pool, std::vector<SystemTime>* times = nullptr) const -> void;
+    auto run_serial(Context& context) const -> void;
+    [[nodiscard]] auto stages() const -> std::vector<std::vector<std::string_view>>;
+
+private:
+    struct Entry
+    {
+        std::string_view name;
+        System system;
+        std::vector<std::type_index> reads;
+        std::vector<std::type_index> writes;
+    };
+
+    std::vector<Entry> m_systems;
+    // indices of m_systems, each stage runs once every system in the stages before it is done
+    std::vector<std::vector<size_t>> m_stages;
+
+    auto run_system(Context& context, size_t index, std::vector<SystemTime>* times) const -> void;
+    [[nodiscard]] static auto conflicts(Entry const& entry1, Entry const& entry2) -> bool;
+};
+} // namespace seb_engine
+
+/****************************
+ *                          *
+ * TEMPLATE IMPLEMENTATIONS *
+ *                          *
+ ****************************/
+
+namespace seb_engine
+{
+namespace slog = seblib::log;
+
+template <typename... Ts>
+auto Reads<Ts...>::types() -> std::vector<std::type_index>
+{
+    return { std::type_index{ typeid(Ts) }... };
+}
+
+template <typename... Ts>
+auto Writes<Ts...>::types() -> std::vector<std::type_index>
+{
+    return { std::type_index{ typeid(Ts) }... };
+}
+
+// the system is placed in the stage after the last one holding a system it conflicts with
+template <typename Context>
+template <typename R, typename W>
+auto Scheduler<Context>::add(const std::string_view name, System system) -> void
+{
+    Entry entry{ .name = name, .system = std::move(system), .reads = R::types(), .writes = W::types() };
+    size_t stage{ 0 };
+    for (size_t i{ m_stages.size() }; i > 0; i--)
+    {
+        const auto conflicting{ [&](const size_t index) { return conflicts(m_systems[index], entry); } };
+        if (std::ranges::any_of(m_stages[i - 1], conflicting))
+        {
+            stage = i;
+            break;
+        }
+    }
+
+    if (stage == m_stages.size())
+    {
+        m_stages.emplace_back();
+    }
+
+    slog::log(slog::TRC, "Scheduling system {} in stage {}", name, stage);
+    m_stages[stage].push_back(m_systems.size());
+    m_systems.push_back(std::move(entry));
+}
+
+// the first system of each stage runs on the calling thread, so stages with a single system never touch the pool
+// when times is given, it is replaced with how long each system took, in the order they were added
+// jobs only capture the shared state by pointer along with their index, so they fit in std::function's inline buffer
+template <typename Context>
+auto Scheduler<Context>::run(Context& context, sj::Pool& pool, std::vector<SystemTime>* times) const -> void
+{
+    if (times != nullptr)
+    {
+        times->resize(m_systems.size());
+    }
+
+    const struct
+    {
+        Scheduler const* scheduler;
+        Context* context;
+        std::vector<SystemTime>* times;
+    } shared{ .scheduler = this, .context = &context, .times = times };
+    for (auto const& stage : m_stages)
+    {
+        sj::Counter counter;
+        for (const auto index : stage | std::views::drop(1))
+        {
+            pool.submit(
+                [&shared, index]() { shared.scheduler->run_system(*shared.context, index, shared.times); }, &counter
+            );
+        }
+
+        run_system(context, stage.front(), times);
+        pool.wait(counter);
+    }
+}
+
+// runs every system in the order it was added
+template <typename Context>
+auto Scheduler<Context>::run_serial(Context& context) const -> void
+{
+    for (auto const& entry : m_systems)
+    {
+        entry.system(context);
+    }
+}
+
+template <typename Context>
+auto Scheduler<Context>::stages() const -> std::vector<std::vector<std::string_view>>
+{
+    std::vector<std::vector<std::string_view>> stages;
+    for (auto const& stage : m_stages)
+    {
+        auto& names{ stages.emplace_back() };
+        for (const auto index : stage)
+        {
+            names.push_back(m_systems[index].name);
+        }
+    }
+
+    return stages;
+}
+
+// each system only writes its own time, so systems running at once never touch the same element
+template <typename Context>
+auto Scheduler<Context>::run_system(Context& context, const size_t index, std::vector<SystemTime>* times) const -> void
+{
+    auto const& entry{ m_systems[index] };
+    SL_PROFILE_ZONE(entry.name);
+    if (times == nullptr)
+    {
+        entry.system(context);
+        return;
+    }
+
+    const auto start{ std::chrono::steady_clock::now() };
+    entry.system(context);
+    (*times)[index] = SystemTime{ .name = entry.name, .time = std::chrono::steady_clock::now() - start };
+}
+
+template <typename Context>
+auto Scheduler<Context>::conflicts(Entry const& entry1, Entry const& entry2) -> bool
+{
+    const auto overlaps{
+        [](std::vector<std::type_index> const& types1, std::vector<std::type_index> const& types2)
+        { return std::ranges::any_of(types1, [&](const auto type) { return std::ranges::contains(types2, type); }); }
+    };
+
+    return overlaps(entry1.writes, entry2.reads)
+        || overlaps(entry1.writes, entry2.writes)
+        || overlaps(entry2.writes, entry1.reads);
+}
+} // namespace seb_engine
+
+#endif
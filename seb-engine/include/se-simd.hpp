@@ -0,0 +1,26 @@
+#ifndef SE_SIMD_HPP_
+#define SE_SIMD_HPP_
+
+#include "se-components.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace seb_engine::simd
+{
+// instruction sets the kernels can use, in order of preference
+enum class Level : uint8_t
+{
+    Scalar,
+    Sse,
+    Avx2,
+};
+
+[[nodiscard]] auto detected_level() -> Level;
+[[nodiscard]] auto level_name(Level level) -> std::string_view;
+auto integrate(std::span<Pos> pos, std::span<const Vel> vel, float dt) -> void;
+auto integrate(std::span<Pos> pos, std::span<const Vel> vel, float dt, Level level) -> void;
+} // namespace seb_engine::simd
+
+#endif
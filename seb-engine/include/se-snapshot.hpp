@@ -0,0 +1,177 @@
+#ifndef SE_SNAPSHOT_HPP_
+#define SE_SNAPSHOT_HPP_
+
+#include "se-paged.hpp"
+#include "sl-log.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace seb_engine::snapshot
+{
+// bumped whenever the layout of the file itself changes
+inline constexpr uint32_t FORMAT_VERSION{ 1 };
+// section data starts on this alignment relative to the start of the file, which is mapped page aligned, so sections
+// can be read in place as arrays of anything aligned to at most this
+inline constexpr size_t SECTION_ALIGN{ 16 };
+
+struct Header
+{
+    std::array<char, 8> magic;
+    uint32_t format_version;
+    // set by whatever writes the snapshot, bumped when what it writes changes
+    uint32_t version;
+};
+
+struct SectionHeader
+{
+    uint64_t count;
+    uint32_t element_size;
+    uint32_t padding;
+};
+
+static_assert(sizeof(Header) % SECTION_ALIGN == 0 && sizeof(SectionHeader) % SECTION_ALIGN == 0);
+
+template <typename T>
+concept Pod = std::is_trivially_copyable_v<T> && alignof(T) <= SECTION_ALIGN;
+
+// a snapshot is a header followed by sections, each an array of trivially copyable values copied byte for byte from
+// memory, so it only loads in builds where those types have the same layout
+// sections carry no names, so they must be read back in the order they were written
+// everything is gathered into one buffer, which is written to the file in one go
+class Writer
+{
+public:
+    explicit Writer(uint32_t version);
+
+    template <Pod T>
+    auto write(std::span<const T> values) -> void;
+    template <Pod T, size_t PageSize>
+    auto write(Paged<T, PageSize> const& values) -> void;
+    template <Pod T>
+    auto write_value(T const& value) -> void;
+    [[nodiscard]] auto save(std::filesystem::path const& path) const -> bool;
+
+private:
+    std::vector<std::byte> m_buffer;
+
+    [[nodiscard]] auto section(uint64_t count, uint32_t element_size) -> std::byte*;
+};
+
+// maps the file into memory rather than reading it, so sections are used straight from the mapping without being
+// parsed or copied
+// a section which doesn't match what is read marks the reader as failed, after which every read returns nothing
+class Reader
+{
+public:
+    Reader(std::filesystem::path const& path, uint32_t version);
+    Reader(Reader const&) = delete;
+    Reader(Reader&&) = delete;
+    auto operator=(Reader const&) -> Reader& = delete;
+    auto operator=(Reader&&) -> Reader& = delete;
+    ~Reader();
+
+    template <Pod T>
+    [[nodiscard]] auto read() -> std::span<const T>;
+    template <Pod T, size_t PageSize>
+    auto read(Paged<T, PageSize>& values) -> void;
+    template <Pod T>
+    [[nodiscard]] auto read_value() -> T;
+    auto fail(std::string_view reason) -> void;
+    [[nodiscard]] auto ok() const -> bool;
+
+private:
+    const std::byte* m_data{ nullptr };
+    size_t m_size{ 0 };
+    size_t m_offset{ 0 };
+    bool m_ok{ true };
+#if defined(_WIN32) || defined(__CYGWIN__)
+    void* m_file{ nullptr };
+    void* m_mapping{ nullptr };
+#endif
+
+    [[nodiscard]] auto section(uint32_t element_size) -> std::span<const std::byte>;
+    auto unmap() -> void;
+};
+} // namespace seb_engine::snapshot
+
+/****************************
+ *                          *
+ * TEMPLATE IMPLEMENTATIONS *
+ *                          *
+ ****************************/
+
+namespace seb_engine::snapshot
+{
+template <Pod T>
+auto Writer::write(const std::span<const T> values) -> void
+{
+    auto* data{ section(values.size(), sizeof(T)) };
+    // an empty span can have a null data pointer, which memcpy mustn't be given even to copy nothing
+    if (!values.empty())
+    {
+        std::memcpy(data, values.data(), values.size_bytes());
+    }
+}
+
+// pages are written one after the other, so the section reads back as a single array
+template <Pod T, size_t PageSize>
+auto Writer::write(Paged<T, PageSize> const& values) -> void
+{
+    auto* data{ section(values.size(), sizeof(T)) };
+    for (size_t page{ 0 }; page < values.page_count(); page++)
+    {
+        const auto page_values{ values.page(page) };
+        std::memcpy(data, page_values.data(), page_values.size_bytes());
+        data += page_values.size_bytes();
+    }
+}
+
+template <Pod T>
+auto Writer::write_value(T const& value) -> void
+{
+    write(std::span{ &value, 1 });
+}
+
+template <Pod T>
+auto Reader::read() -> std::span<const T>
+{
+    const auto bytes{ section(sizeof(T)) };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return { reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T) };
+}
+
+// replaces the contents of values with the section
+template <Pod T, size_t PageSize>
+auto Reader::read(Paged<T, PageSize>& values) -> void
+{
+    const auto section{ read<T>() };
+    if (ok())
+    {
+        values.assign(section);
+    }
+}
+
+// returns a default constructed value if the section doesn't hold exactly one
+template <Pod T>
+auto Reader::read_value() -> T
+{
+    const auto values{ read<T>() };
+    if (ok() && values.size() != 1)
+    {
+        fail("expected a single value");
+    }
+
+    return (ok() ? values.front() : T{});
+}
+} // namespace seb_engine::snapshot
+
+#endif
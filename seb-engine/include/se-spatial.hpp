@@ -0,0 +1,99 @@
+#ifndef SE_SPATIAL_HPP_
+#define SE_SPATIAL_HPP_
+
+#include "sl-math.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace seb_engine
+{
+namespace rl = raylib;
+
+// broadphase over world space, split into square cells which are hashed into buckets, so the world can be any size
+// each value is stored in every cell its bounds overlap, and a query only looks at the cells its own bounds overlap
+// rebuilt from scratch with clear, insert and build, reusing its storage so a steady number of values doesn't allocate
+class SpatialHash
+{
+public:
+    explicit SpatialHash(float cell_size);
+
+    auto clear() -> void;
+    auto insert(size_t value, rl::Rectangle bounds) -> void;
+    auto build() -> void;
+    template <typename Func>
+    auto query(rl::Rectangle bounds, Func&& func) const -> void;
+
+private:
+    struct CellRange
+    {
+        int32_t min_x{ 0 };
+        int32_t min_y{ 0 };
+        int32_t max_x{ 0 };
+        int32_t max_y{ 0 };
+    };
+
+    // one per cell a value's bounds overlap
+    struct Entry
+    {
+        size_t value{ 0 };
+        int32_t x{ 0 };
+        int32_t y{ 0 };
+        CellRange range;
+    };
+
+    float m_cell_size;
+    std::vector<Entry> m_inserted;
+    // m_inserted grouped by bucket, with the entries of bucket i from m_bucket_starts[i] to m_bucket_starts[i + 1]
+    std::vector<Entry> m_entries;
+    std::vector<size_t> m_bucket_starts;
+
+    [[nodiscard]] auto cell_range(rl::Rectangle bounds) const -> CellRange;
+    [[nodiscard]] auto bucket(int32_t x, int32_t y) const -> size_t;
+};
+} // namespace seb_engine
+
+/****************************
+ *                          *
+ * TEMPLATE IMPLEMENTATIONS *
+ *                          *
+ ****************************/
+
+namespace seb_engine
+{
+// calls func(value) once for every value sharing a cell with bounds, in an order which only depends on what was
+// inserted, so is the same between runs
+// values are candidates only, whether they actually overlap is left to the caller
+// a value spanning several cells is reported from the first cell it shares with the query, so it is never repeated,
+// and entries from other cells hashed into the same bucket are skipped
+template <typename Func>
+auto SpatialHash::query(const rl::Rectangle bounds, Func&& func) const -> void
+{
+    if (m_entries.empty())
+    {
+        return;
+    }
+
+    const auto range{ cell_range(bounds) };
+    for (auto x{ range.min_x }; x <= range.max_x; x++)
+    {
+        for (auto y{ range.min_y }; y <= range.max_y; y++)
+        {
+            const auto index{ bucket(x, y) };
+            for (auto i{ m_bucket_starts[index] }; i < m_bucket_starts[index + 1]; i++)
+            {
+                auto const& entry{ m_entries[i] };
+                if (entry.x == x && entry.y == y && x == std::max(range.min_x, entry.range.min_x)
+                    && y == std::max(range.min_y, entry.range.min_y))
+                {
+                    func(entry.value);
+                }
+            }
+        }
+    }
+}
+} // namespace seb_engine
+
+#endif
@@ -1,12 +1,18 @@
 #ifndef SE_SPRITE_HPP_
 #define SE_SPRITE_HPP_
 
+#include "se-paged.hpp"
+#include "se-snapshot.hpp"
 #include "seblib.hpp"
 #include "sl-log.hpp"
 #include "sl-math.hpp"
 
+#include <cstddef>
 #include <ranges>
+#include <span>
 #include <tuple>
+#include <type_traits>
+#include <vector>
 
 namespace seb_engine
 {
@@ -58,15 +64,23 @@ private:
     [[nodiscard]] auto rect(bool flipped) const -> rl::Rectangle;
 };
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+template <sl::Enumerable... Sprite>
 class EntitySprites;
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+// storage must be grown with resize to cover every id before it is used
+template <sl::Enumerable... Sprite>
 class Sprites
 {
 public:
+    // the snapshot sections holding each sprite part, viewed in place in the reader's mapping
+    struct Sections
+    {
+        std::tuple<std::span<const SpritePart<Sprite>>...> parts;
+    };
+
     Sprites() = default;
 
+    auto resize(size_t capacity) -> void;
     auto draw_all(rl::Texture const& texture_sheet, sm::Vec2 pos, float dt, bool flipped) -> void;
     auto draw(rl::Texture const& texture_sheet, sm::Vec2 pos, unsigned id, float dt, bool flipped) -> void;
     template <typename S>
@@ -77,7 +91,7 @@ public:
     auto set(unsigned id, S sprite, float duration) -> void;
     template <typename S>
     auto movement_set(unsigned id, S sprite) -> void;
-    [[nodiscard]] auto by_id(unsigned id) -> EntitySprites<MaxEntities, Sprite...>;
+    [[nodiscard]] auto by_id(unsigned id) -> EntitySprites<Sprite...>;
     template <typename S>
     [[nodiscard]] auto sprite(unsigned id) const -> S;
     template <typename S>
@@ -85,9 +99,12 @@ public:
     auto unset(unsigned id) -> void;
     template <typename S>
     [[nodiscard]] auto details(unsigned id) const -> SpriteDetails;
+    auto save(snapshot::Writer& writer) const -> void;
+    [[nodiscard]] auto read(snapshot::Reader& reader, size_t capacity) const -> Sections;
+    auto load(Sections const& sections) -> void;
 
 private:
-    std::vector<std::tuple<SpritePart<Sprite>...>> m_sprites{ MaxEntities };
+    Paged<std::tuple<SpritePart<Sprite>...>> m_sprites;
 
     template <typename S>
     [[nodiscard]] auto part_mut(unsigned id) -> SpritePart<S>&;
@@ -95,7 +112,7 @@ private:
     [[nodiscard]] auto part(unsigned id) const -> SpritePart<S> const&;
 };
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+template <sl::Enumerable... Sprite>
 class EntitySprites
 {
 public:
@@ -106,13 +123,13 @@ public:
     template <typename S>
     [[maybe_unused]] auto movement_set(S sprite) -> EntitySprites&;
 
-    friend Sprites<MaxEntities, Sprite...>;
+    friend Sprites<Sprite...>;
 
 private:
-    Sprites<MaxEntities, Sprite...>* m_sprites;
+    Sprites<Sprite...>* m_sprites;
     unsigned m_id;
 
-    EntitySprites(Sprites<MaxEntities, Sprite...>& sprites, unsigned id);
+    EntitySprites(Sprites<Sprite...>& sprites, unsigned id);
 };
 } // namespace seb_engine
 
@@ -225,8 +242,17 @@ auto SpritePart<Sprite>::rect(const bool flipped) const -> rl::Rectangle
     return { pos, size };
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
-auto Sprites<MaxEntities, Sprite...>::draw_all(
+template <sl::Enumerable... Sprite>
+auto Sprites<Sprite...>::resize(const size_t capacity) -> void
+{
+    if (capacity > m_sprites.size())
+    {
+        m_sprites.resize(capacity);
+    }
+}
+
+template <sl::Enumerable... Sprite>
+auto Sprites<Sprite...>::draw_all(
     rl::Texture const& texture_sheet, const sm::Vec2 pos, const float dt, const bool flipped
 ) -> void
 {
@@ -236,74 +262,74 @@ auto Sprites<MaxEntities, Sprite...>::draw_all(
     }
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
-auto Sprites<MaxEntities, Sprite...>::draw(
+template <sl::Enumerable... Sprite>
+auto Sprites<Sprite...>::draw(
     rl::Texture const& texture_sheet, const sm::Vec2 pos, const unsigned id, const float dt, const bool flipped
 ) -> void
 {
     (draw_part<Sprite>(texture_sheet, pos, id, dt, flipped), ...);
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+template <sl::Enumerable... Sprite>
 template <typename S>
-auto Sprites<MaxEntities, Sprite...>::draw_part(
+auto Sprites<Sprite...>::draw_part(
     rl::Texture const& texture_sheet, const sm::Vec2 pos, const unsigned id, const float dt, const bool flipped
 ) -> void
 {
     part_mut<S>(id).draw(texture_sheet, pos, dt, flipped);
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+template <sl::Enumerable... Sprite>
 template <typename S>
-auto Sprites<MaxEntities, Sprite...>::set(const unsigned id, const S sprite) -> void
+auto Sprites<Sprite...>::set(const unsigned id, const S sprite) -> void
 {
     part_mut<S>(id).set(sprite);
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+template <sl::Enumerable... Sprite>
 template <typename S>
-auto Sprites<MaxEntities, Sprite...>::set(const unsigned id, const S sprite, const float duration) -> void
+auto Sprites<Sprite...>::set(const unsigned id, const S sprite, const float duration) -> void
 {
     part_mut<S>(id).set(sprite, duration);
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+template <sl::Enumerable... Sprite>
 template <typename S>
-auto Sprites<MaxEntities, Sprite...>::movement_set(const unsigned id, const S sprite) -> void
+auto Sprites<Sprite...>::movement_set(const unsigned id, const S sprite) -> void
 {
     part_mut<S>(id).movement_set(sprite);
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
-auto Sprites<MaxEntities, Sprite...>::by_id(const unsigned id) -> EntitySprites<MaxEntities, Sprite...>
+template <sl::Enumerable... Sprite>
+auto Sprites<Sprite...>::by_id(const unsigned id) -> EntitySprites<Sprite...>
 {
     return { *this, id };
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+template <sl::Enumerable... Sprite>
 template <typename S>
-auto Sprites<MaxEntities, Sprite...>::sprite(const unsigned id) const -> S
+auto Sprites<Sprite...>::sprite(const unsigned id) const -> S
 {
     return part<S>(id).sprite();
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+template <sl::Enumerable... Sprite>
 template <typename S>
-auto Sprites<MaxEntities, Sprite...>::current_frame(const unsigned id) const -> unsigned
+auto Sprites<Sprite...>::current_frame(const unsigned id) const -> unsigned
 {
     return part<S>(id).current_frame();
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
-auto Sprites<MaxEntities, Sprite...>::unset(const unsigned id) -> void
+template <sl::Enumerable... Sprite>
+auto Sprites<Sprite...>::unset(const unsigned id) -> void
 {
     slog::log(slog::TRC, "Unsetting sprite parts for entity id {}", id);
     (part_mut<Sprite>(id).unset(), ...);
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+template <sl::Enumerable... Sprite>
 template <typename S>
-auto Sprites<MaxEntities, Sprite...>::details(unsigned id) const -> SpriteDetails
+auto Sprites<Sprite...>::details(unsigned id) const -> SpriteDetails
 {
     const auto sprite_part{ part<S>(id) };
     const auto sprite{ sprite_part.sprite() };
@@ -311,39 +337,91 @@ auto Sprites<MaxEntities, Sprite...>::details(unsigned id) const -> SpriteDetail
     return sprite_part.s_details.get(sprite);
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+// tuples aren't trivially copyable, so each part is gathered into its own section
+template <sl::Enumerable... Sprite>
+auto Sprites<Sprite...>::save(snapshot::Writer& writer) const -> void
+{
+    const auto save_part{ [this, &writer]<typename S>(std::type_identity<S>)
+                          {
+                              std::vector<SpritePart<S>> parts;
+                              parts.reserve(m_sprites.size());
+                              for (auto const& sprites : m_sprites)
+                              {
+                                  parts.push_back(std::get<SpritePart<S>>(sprites));
+                              }
+
+                              writer.write(std::span<const SpritePart<S>>{ parts });
+                          } };
+    writer.write_value(m_sprites.size());
+    (save_part(std::type_identity<Sprite>{}), ...);
+}
+
+// nothing is changed, the sprites are only replaced by passing what is returned to load
+template <sl::Enumerable... Sprite>
+auto Sprites<Sprite...>::read(snapshot::Reader& reader, const size_t capacity) const -> Sections
+{
+    const auto saved_capacity{ reader.read_value<size_t>() };
+    const Sections sections{ .parts = { reader.read<SpritePart<Sprite>>()... } };
+    const auto sized{ std::apply(
+        [capacity](auto const&... parts) { return ((parts.size() == capacity) && ...); }, sections.parts
+    ) };
+    if (reader.ok() && (saved_capacity != capacity || !sized))
+    {
+        reader.fail("the sprites are inconsistent");
+    }
+
+    return sections;
+}
+
+// sections must have been returned by read from a reader which is still ok
+template <sl::Enumerable... Sprite>
+auto Sprites<Sprite...>::load(Sections const& sections) -> void
+{
+    const auto capacity{ std::get<0>(sections.parts).size() };
+    const auto load_part{ [this, capacity]<typename S>(std::span<const SpritePart<S>> parts)
+                          {
+                              for (size_t id{ 0 }; id < capacity; id++)
+                              {
+                                  std::get<SpritePart<S>>(m_sprites[id]) = parts[id];
+                              }
+                          } };
+    m_sprites.resize(capacity);
+    std::apply([&load_part](auto const&... parts) { (load_part(parts), ...); }, sections.parts);
+}
+
+template <sl::Enumerable... Sprite>
 template <typename S>
-auto Sprites<MaxEntities, Sprite...>::part_mut(const unsigned id) -> SpritePart<S>&
+auto Sprites<Sprite...>::part_mut(const unsigned id) -> SpritePart<S>&
 {
     return std::get<SpritePart<S>>(m_sprites[id]);
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+template <sl::Enumerable... Sprite>
 template <typename S>
-auto Sprites<MaxEntities, Sprite...>::part(const unsigned id) const -> SpritePart<S> const&
+auto Sprites<Sprite...>::part(const unsigned id) const -> SpritePart<S> const&
 {
     return std::get<SpritePart<S>>(m_sprites[id]);
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
-EntitySprites<MaxEntities, Sprite...>::EntitySprites(Sprites<MaxEntities, Sprite...>& sprites, const unsigned id)
+template <sl::Enumerable... Sprite>
+EntitySprites<Sprite...>::EntitySprites(Sprites<Sprite...>& sprites, const unsigned id)
     : m_sprites{ &sprites }
     , m_id{ id }
 {
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+template <sl::Enumerable... Sprite>
 template <typename S>
-auto EntitySprites<MaxEntities, Sprite...>::set(const S sprite) -> EntitySprites&
+auto EntitySprites<Sprite...>::set(const S sprite) -> EntitySprites&
 {
     m_sprites->set(m_id, sprite);
 
     return *this;
 }
 
-template <size_t MaxEntities, sl::Enumerable... Sprite>
+template <sl::Enumerable... Sprite>
 template <typename S>
-auto EntitySprites<MaxEntities, Sprite...>::movement_set(const S sprite) -> EntitySprites&
+auto EntitySprites<Sprite...>::movement_set(const S sprite) -> EntitySprites&
 {
     m_sprites->movement_set(m_id, sprite);
 
@@ -2,6 +2,7 @@
 #define SE_TILES_HPP_
 
 #include "se-bbox.hpp"
+#include "se-snapshot.hpp"
 #include "se-sprite.hpp"
 #include "seb-engine.hpp"
 #include "seblib.hpp"
@@ -12,7 +13,9 @@
 #include <cmath>
 #include <cstddef>
 #include <functional>
+#include <optional>
 #include <ranges>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -38,10 +41,13 @@ struct TileDetails
 };
 
 // register tile details by specialising this template
+// valid says whether a value is one of Tile's enumerators, so tiles read from a snapshot are checked before get sees
+// them
 template <sl::Enumerable Tile, sl::Enumerable Sprite>
 struct TileDetailsLookup
 {
     static auto get(Tile) -> TileDetails<Sprite>;
+    static auto valid(Tile) -> bool;
 };
 
 // assumes Tile has a "no tile" value of 0
@@ -49,12 +55,22 @@ template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Heigh
 class World
 {
 public:
+    // the snapshot section holding the tiles, viewed in place in the reader's mapping
+    struct Sections
+    {
+        std::span<const Tile> tiles;
+    };
+
+    World();
+
     auto place_tile(Tile tile, Coords<TileSize> coords) -> void;
     auto replace_tile(Tile tile, Coords<TileSize> coords) -> void;
     auto remove_tile(Coords<TileSize> coords) -> void;
+    auto set_tiles(std::span<const Tile> tiles) -> void;
     auto draw(rl::Texture const& texture_sheet, float dt) -> void;
     [[nodiscard]] auto tiles() const -> std::vector<Tile> const&;
     [[nodiscard]] auto cboxes() const -> std::vector<rl::Rectangle> const&;
+    auto cboxes_in(rl::Rectangle bounds, std::vector<size_t>& ids) const -> void;
     auto draw_cboxes() const -> void;
     auto calculate_cboxes() -> void;
     [[nodiscard]] auto row(size_t y, size_t min_x, size_t max_x) const;
@@ -62,11 +78,18 @@ public:
     [[nodiscard]] auto tile_cbox(Coords<TileSize> coords) const -> BBoxVariant;
     [[nodiscard]] auto new_tile_cbox(Tile tile, Coords<TileSize> coords) const -> BBoxVariant;
     [[nodiscard]] auto at(Coords<TileSize> coords) const -> Tile;
+    auto save(snapshot::Writer& writer) const -> void;
+    [[nodiscard]] auto read(snapshot::Reader& reader) const -> Sections;
+    auto load(Sections const& sections) -> void;
 
 private:
     std::vector<Tile> m_tiles{ Width * Height, static_cast<Tile>(0) };
     std::vector<rl::Rectangle> m_cboxes;
-    Sprites<Width * Height, Sprite> m_sprites;
+    // the ids of the cboxes covering each tile, with those of tile id from m_tile_cbox_starts[id] to
+    // m_tile_cbox_starts[id + 1]
+    std::vector<size_t> m_tile_cbox_starts;
+    std::vector<size_t> m_tile_cbox_ids;
+    Sprites<Sprite> m_sprites;
 
     static TileDetailsLookup<Tile, Sprite> s_details;
 
@@ -77,6 +100,11 @@ private:
     [[nodiscard]] auto id_from_coords(Coords<TileSize> coords) const -> size_t;
     [[nodiscard]] auto tile_in_cboxes(Coords<TileSize> coords) const -> bool;
     [[nodiscard]] auto cbox_from_tile_type(TileType type) const -> BBox;
+    [[nodiscard]] auto tiles_touching(rl::Rectangle bounds) const
+        -> std::optional<std::pair<Coords<TileSize>, Coords<TileSize>>>;
+    template <typename Func>
+    auto for_covered(rl::Rectangle cbox, Func&& func) const -> void;
+    auto index_cboxes() -> void;
 };
 
 } // namespace seb_engine
@@ -89,10 +117,17 @@ private:
 
 namespace seb_engine
 {
+template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
+World<Tile, Sprite, Width, Height, TileSize>::World()
+{
+    m_tile_cbox_starts.resize((Width * Height) + 1);
+    m_sprites.resize(Width * Height);
+}
+
 template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
 auto World<Tile, Sprite, Width, Height, TileSize>::place_tile(const Tile tile, const Coords<TileSize> coords) -> void
 {
-    if (at(coords) == static_cast<Tile>(0))
+    if (coords.x < Width && coords.y < Height && at(coords) == static_cast<Tile>(0))
     {
         replace_tile(tile, coords);
     }
@@ -101,7 +136,7 @@ auto World<Tile, Sprite, Width, Height, TileSize>::place_tile(const Tile tile, c
 template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
 auto World<Tile, Sprite, Width, Height, TileSize>::replace_tile(const Tile tile, const Coords<TileSize> coords) -> void
 {
-    if (coords.x > Width || coords.y > Height)
+    if (coords.x >= Width || coords.y >= Height)
     {
         return;
     }
@@ -118,6 +153,21 @@ auto World<Tile, Sprite, Width, Height, TileSize>::remove_tile(const Coords<Tile
     replace_tile(static_cast<Tile>(0), coords);
 }
 
+// replaces every tile at once, only calculating the cboxes after all of them are set
+template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
+auto World<Tile, Sprite, Width, Height, TileSize>::set_tiles(const std::span<const Tile> tiles) -> void
+{
+    assert(tiles.size() == m_tiles.size());
+
+    for (const auto [id, tile] : tiles | views::enumerate)
+    {
+        at_mut(static_cast<size_t>(id)) = tile;
+        m_sprites.set(static_cast<unsigned>(id), s_details.get(tile).sprite);
+    }
+
+    calculate_cboxes();
+}
+
 template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
 auto World<Tile, Sprite, Width, Height, TileSize>::draw(rl::Texture const& texture_sheet, const float dt) -> void
 {
@@ -139,6 +189,38 @@ auto World<Tile, Sprite, Width, Height, TileSize>::cboxes() const -> std::vector
     return m_cboxes;
 }
 
+// fills ids with the cboxes covering the tiles bounds overlaps or touches, in the order of cboxes()
+// only the tiles under bounds are looked at, so this costs the same however large the world is
+template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
+auto World<Tile, Sprite, Width, Height, TileSize>::cboxes_in(const rl::Rectangle bounds, std::vector<size_t>& ids) const
+    -> void
+{
+    ids.clear();
+    const auto range{ tiles_touching(bounds) };
+    if (!range.has_value())
+    {
+        return;
+    }
+
+    const auto [min, max]{ range.value() };
+    for (auto x{ min.x }; x <= max.x; x++)
+    {
+        for (auto y{ min.y }; y <= max.y; y++)
+        {
+            const auto id{ id_from_coords({ x, y }) };
+            ids.insert(
+                ids.end(),
+                m_tile_cbox_ids.begin() + static_cast<std::ptrdiff_t>(m_tile_cbox_starts[id]),
+                m_tile_cbox_ids.begin() + static_cast<std::ptrdiff_t>(m_tile_cbox_starts[id + 1])
+            );
+        }
+    }
+
+    ranges::sort(ids);
+    const auto duplicates{ ranges::unique(ids) };
+    ids.erase(duplicates.begin(), duplicates.end());
+}
+
 template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
 auto World<Tile, Sprite, Width, Height, TileSize>::draw_cboxes() const -> void
 {
@@ -172,10 +254,13 @@ auto World<Tile, Sprite, Width, Height, TileSize>::calculate_cboxes() -> void
         auto coords_max{ coords + Coords<TileSize>{ 1, 1 } };
         while (check_right || check_top)
         {
+            // the cbox stops growing at the edges of the world, rather than reading the tiles past them
+            check_right = check_right && coords_max.x < Width;
+            check_top = check_top && coords_max.y < Height;
             const auto top_right_not_empty{ check_right && check_top && at(coords_max) != static_cast<Tile>(0) };
             const auto top_not_empty{ check_top
                                       && ranges::all_of(row(coords_max.y, coords.x, coords_max.x - 1), non_empty) };
-            const auto top_in_cboxes{ ranges::any_of(
+            const auto top_in_cboxes{ check_top && ranges::any_of(
                 views::iota(coords.x, coords_max.x)
                     | views::transform([coords_max, this](const auto x)
                                        { return tile_in_cboxes({ x, coords_max.y }); }),
@@ -211,6 +296,8 @@ auto World<Tile, Sprite, Width, Height, TileSize>::calculate_cboxes() -> void
 
         m_cboxes.emplace_back(tile_cbox);
     }
+
+    index_cboxes();
 }
 
 template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
@@ -261,8 +348,8 @@ auto World<Tile, Sprite, Width, Height, TileSize>::new_tile_cbox(Tile tile, Coor
 template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
 auto World<Tile, Sprite, Width, Height, TileSize>::at(const Coords<TileSize> coords) const -> Tile
 {
-    assert(coords.x <= Width);
-    assert(coords.y <= Height);
+    assert(coords.x < Width);
+    assert(coords.y < Height);
 
     const auto tile{ m_tiles[coords.y + (Height * coords.x)] };
     slog::log(slog::TRC, "Tile at {} is {}", coords, std::to_underlying(tile));
@@ -270,6 +357,38 @@ auto World<Tile, Sprite, Width, Height, TileSize>::at(const Coords<TileSize> coo
     return tile;
 }
 
+template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
+auto World<Tile, Sprite, Width, Height, TileSize>::save(snapshot::Writer& writer) const -> void
+{
+    writer.write(std::span<const Tile>{ m_tiles });
+}
+
+// nothing is changed, the tiles are only replaced by passing what is returned to load
+template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
+auto World<Tile, Sprite, Width, Height, TileSize>::read(snapshot::Reader& reader) const -> Sections
+{
+    const Sections sections{ .tiles = reader.read<Tile>() };
+    if (reader.ok() && sections.tiles.size() != m_tiles.size())
+    {
+        reader.fail("the world is a different size");
+    }
+
+    if (reader.ok() && !ranges::all_of(sections.tiles, [](const Tile tile) { return s_details.valid(tile); }))
+    {
+        reader.fail("the world has a tile which doesn't exist");
+    }
+
+    return sections;
+}
+
+// sections must have been returned by read from a reader which is still ok
+// only the tiles are stored, their sprites and collision boxes are rebuilt from them
+template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
+auto World<Tile, Sprite, Width, Height, TileSize>::load(Sections const& sections) -> void
+{
+    set_tiles(sections.tiles);
+}
+
 template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
 auto World<Tile, Sprite, Width, Height, TileSize>::at(const size_t id) const -> Tile
 {
@@ -279,8 +398,8 @@ auto World<Tile, Sprite, Width, Height, TileSize>::at(const size_t id) const ->
 template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
 auto World<Tile, Sprite, Width, Height, TileSize>::at_mut(const Coords<TileSize> coords) -> Tile&
 {
-    assert(coords.x <= Width);
-    assert(coords.y <= Height);
+    assert(coords.x < Width);
+    assert(coords.y < Height);
 
     return m_tiles[coords.y + (Height * coords.x)];
 }
@@ -327,6 +446,87 @@ auto World<Tile, Sprite, Width, Height, TileSize>::cbox_from_tile_type(const Til
 
     std::unreachable();
 }
+
+// the tiles whose squares overlap or touch bounds, clipped to the world, or nothing if bounds is entirely outside it
+// tile y counts up as world y counts down, so the square of tile y spans world y from -y to -(y - 1) tiles
+template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
+auto World<Tile, Sprite, Width, Height, TileSize>::tiles_touching(const rl::Rectangle bounds) const
+    -> std::optional<std::pair<Coords<TileSize>, Coords<TileSize>>>
+{
+    const auto tile_len{ static_cast<float>(TileSize) };
+    const auto min_x{ std::ceil((bounds.x / tile_len) - 1) };
+    const auto max_x{ std::floor((bounds.x + bounds.width) / tile_len) };
+    const auto min_y{ std::ceil(-(bounds.y + bounds.height) / tile_len) };
+    const auto max_y{ std::floor(1 - (bounds.y / tile_len)) };
+    if (max_x < 0 || max_y < 0 || min_x >= static_cast<float>(Width) || min_y >= static_cast<float>(Height))
+    {
+        return std::nullopt;
+    }
+
+    return std::pair{
+        Coords<TileSize>{ static_cast<size_t>(std::max(min_x, 0.0F)), static_cast<size_t>(std::max(min_y, 0.0F)) },
+        Coords<TileSize>{ static_cast<size_t>(std::min(max_x, static_cast<float>(Width - 1))),
+                          static_cast<size_t>(std::min(max_y, static_cast<float>(Height - 1))) },
+    };
+}
+
+// calls func(id) for each tile cbox covers, found by shrinking it by half a tile so the tiles only touching its edges
+// are left out
+template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
+template <typename Func>
+auto World<Tile, Sprite, Width, Height, TileSize>::for_covered(const rl::Rectangle cbox, Func&& func) const -> void
+{
+    const auto half{ static_cast<float>(TileSize) / 2 };
+    const auto range{ tiles_touching(
+        rl::Rectangle{ cbox.x + half, cbox.y + half, cbox.width - TileSize, cbox.height - TileSize }
+    ) };
+    if (!range.has_value())
+    {
+        return;
+    }
+
+    const auto [min, max]{ range.value() };
+    for (auto x{ min.x }; x <= max.x; x++)
+    {
+        for (auto y{ min.y }; y <= max.y; y++)
+        {
+            func(id_from_coords({ x, y }));
+        }
+    }
+}
+
+// counting sort of the cboxes into the tiles they cover, which keeps them in order within a tile
+template <sl::Enumerable Tile, sl::Enumerable Sprite, size_t Width, size_t Height, unsigned TileSize>
+auto World<Tile, Sprite, Width, Height, TileSize>::index_cboxes() -> void
+{
+    ranges::fill(m_tile_cbox_starts, 0);
+    for (const auto cbox : m_cboxes)
+    {
+        for_covered(cbox, [this](const size_t id) { m_tile_cbox_starts[id + 1]++; });
+    }
+
+    for (size_t i{ 1 }; i < m_tile_cbox_starts.size(); i++)
+    {
+        m_tile_cbox_starts[i] += m_tile_cbox_starts[i - 1];
+    }
+
+    // each start is moved along as its tile fills, leaving it at the start of the next tile
+    m_tile_cbox_ids.resize(m_tile_cbox_starts.back());
+    for (const auto [cbox_id, cbox] : m_cboxes | views::enumerate)
+    {
+        for_covered(
+            cbox, [this, cbox_id](const size_t id)
+            { m_tile_cbox_ids[m_tile_cbox_starts[id]++] = static_cast<size_t>(cbox_id); }
+        );
+    }
+
+    for (auto i{ m_tile_cbox_starts.size() - 1 }; i > 0; i--)
+    {
+        m_tile_cbox_starts[i] = m_tile_cbox_starts[i - 1];
+    }
+
+    m_tile_cbox_starts[0] = 0;
+}
 } // namespace seb_engine
 
 #endif
@@ -67,6 +67,29 @@ auto collides(const BBoxVariant bbox1, const BBoxVariant bbox2) -> bool
     );
 }
 
+// smallest axis aligned rectangle containing the bbox
+auto bounds(const BBoxVariant bbox) -> rl::Rectangle
+{
+    return sl::match(
+        bbox,
+        [](const rl::Rectangle rect) { return rect; },
+        [](const sm::Circle circle)
+        {
+            return rl::Rectangle{
+                circle.pos.x - circle.radius, circle.pos.y - circle.radius, circle.radius * 2, circle.radius * 2
+            };
+        },
+        [](const sm::Line line)
+        {
+            const auto min_x{ std::min(line.pos1.x, line.pos2.x) };
+            const auto min_y{ std::min(line.pos1.y, line.pos2.y) };
+            return rl::Rectangle{
+                min_x, min_y, std::max(line.pos1.x, line.pos2.x) - min_x, std::max(line.pos1.y, line.pos2.y) - min_y
+            };
+        }
+    );
+}
+
 // currently assumes bbox2 is unmoving and unmovable, return value only resolves bbox1 pos
 auto resolve_collision(const BBoxVariant bbox1, const BBoxVariant bbox2) -> sm::Vec2
 {
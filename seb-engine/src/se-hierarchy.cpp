@@ -0,0 +1,202 @@
+#include "se-hierarchy.hpp"
+
+#include "se-entities.hpp"
+#include "se-snapshot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace seb_engine
+{
+auto Hierarchy::resize(const size_t capacity) -> void
+{
+    if (capacity > m_links.size())
+    {
+        m_links.resize(capacity);
+    }
+}
+
+// moves child under parent if it already has one
+auto Hierarchy::attach(const size_t child, const size_t parent) -> void
+{
+    detach(child);
+    auto& child_links{ m_links[child] };
+    auto& parent_links{ m_links[parent] };
+    child_links.parent = parent;
+    child_links.next_sibling = parent_links.first_child;
+    if (parent_links.first_child != NO_ENTITY)
+    {
+        m_links[parent_links.first_child].prev_sibling = child;
+    }
+
+    parent_links.first_child = child;
+}
+
+// the entity keeps its own children
+auto Hierarchy::detach(const size_t id) -> void
+{
+    auto& links{ m_links[id] };
+    if (links.parent == NO_ENTITY)
+    {
+        return;
+    }
+
+    if (links.prev_sibling != NO_ENTITY)
+    {
+        m_links[links.prev_sibling].next_sibling = links.next_sibling;
+    }
+    else
+    {
+        m_links[links.parent].first_child = links.next_sibling;
+    }
+
+    if (links.next_sibling != NO_ENTITY)
+    {
+        m_links[links.next_sibling].prev_sibling = links.prev_sibling;
+    }
+
+    links.parent = NO_ENTITY;
+    links.next_sibling = NO_ENTITY;
+    links.prev_sibling = NO_ENTITY;
+}
+
+auto Hierarchy::parent(const size_t id) const -> std::optional<size_t>
+{
+    const auto parent{ m_links[id].parent };
+
+    return (parent == NO_ENTITY ? std::nullopt : std::optional{ parent });
+}
+
+auto Hierarchy::save(snapshot::Writer& writer) const -> void
+{
+    writer.write(m_links);
+}
+
+auto Hierarchy::read(snapshot::Reader& reader, std::vector<bool> const& live) const -> Sections
+{
+    const Sections sections{ .links = reader.read<Links>() };
+    if (reader.ok() && !consistent(sections.links, live))
+    {
+        reader.fail("the hierarchy links are inconsistent");
+    }
+
+    return sections;
+}
+
+// every link has to be to a live entity which links back, free entities have no links, and following parents or
+// siblings has to come to an end
+auto Hierarchy::consistent(const std::span<const Links> links, std::vector<bool> const& live) -> bool
+{
+    const auto capacity{ links.size() };
+    if (capacity != live.size())
+    {
+        return false;
+    }
+
+    const auto linked{ [&live, capacity](const size_t id) { return id == NO_ENTITY || (id < capacity && live[id]); } };
+    std::vector<size_t> child_counts(capacity, 0);
+    for (size_t id{ 0 }; id < capacity; id++)
+    {
+        auto const& link{ links[id] };
+        if (!live[id])
+        {
+            if (link != Links{})
+            {
+                return false;
+            }
+
+            continue;
+        }
+
+        if (!linked(link.parent) || !linked(link.first_child) || !linked(link.next_sibling)
+            || !linked(link.prev_sibling))
+        {
+            return false;
+        }
+
+        if (link.first_child != NO_ENTITY
+            && (links[link.first_child].parent != id || links[link.first_child].prev_sibling != NO_ENTITY))
+        {
+            return false;
+        }
+
+        if (link.parent == NO_ENTITY)
+        {
+            if (link.next_sibling != NO_ENTITY || link.prev_sibling != NO_ENTITY)
+            {
+                return false;
+            }
+
+            continue;
+        }
+
+        child_counts[link.parent]++;
+        const auto linked_from_prev{ (link.prev_sibling == NO_ENTITY
+                                          ? links[link.parent].first_child == id
+                                          : links[link.prev_sibling].next_sibling == id
+                                                && links[link.prev_sibling].parent == link.parent) };
+        if (!linked_from_prev || (link.next_sibling != NO_ENTITY && links[link.next_sibling].prev_sibling != id))
+        {
+            return false;
+        }
+    }
+
+    // siblings which only link to each other, in a loop, are never reached from their parent's first child
+    for (size_t id{ 0 }; id < capacity; id++)
+    {
+        size_t reached{ 0 };
+        for (auto child{ links[id].first_child }; child != NO_ENTITY && reached <= child_counts[id];
+             child = links[child].next_sibling)
+        {
+            reached++;
+        }
+
+        if (reached != child_counts[id])
+        {
+            return false;
+        }
+    }
+
+    // walks up from each entity, a parent already on the walk means the parents loop
+    enum class Visit : uint8_t
+    {
+        NotYet,
+        OnWalk,
+        Done,
+    };
+    std::vector<Visit> visits(capacity, Visit::NotYet);
+    std::vector<size_t> walk;
+    for (size_t id{ 0 }; id < capacity; id++)
+    {
+        walk.clear();
+        auto node{ id };
+        while (node != NO_ENTITY && visits[node] == Visit::NotYet)
+        {
+            visits[node] = Visit::OnWalk;
+            walk.push_back(node);
+            node = links[node].parent;
+        }
+
+        if (node != NO_ENTITY && visits[node] == Visit::OnWalk)
+        {
+            return false;
+        }
+
+        for (const auto walked : walk)
+        {
+            visits[walked] = Visit::Done;
+        }
+    }
+
+    return true;
+}
+
+// sections must have been returned by read from a reader which is still ok
+auto Hierarchy::load(Sections const& sections) -> void
+{
+    m_links.assign(sections.links);
+}
+} // namespace seb_engine
@@ -0,0 +1,165 @@
+#include "se-simd.hpp"
+
+#include "se-components.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SE_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SE_TARGET_AVX2
+#endif
+
+using namespace seb_engine;
+
+namespace
+{
+// positions and velocities are read as flat arrays of floats, as x and y are integrated the same way
+static_assert(sizeof(Pos) == 2 * sizeof(float) && std::is_standard_layout_v<Pos>);
+static_assert(sizeof(Vel) == 2 * sizeof(float) && std::is_standard_layout_v<Vel>);
+
+auto integrate_scalar(float* pos, const float* vel, size_t count, float dt) -> void;
+#ifdef SE_SIMD_X86
+auto integrate_sse(float* pos, const float* vel, size_t count, float dt) -> void;
+SE_TARGET_AVX2 auto integrate_avx2(float* pos, const float* vel, size_t count, float dt) -> void;
+auto avx2_supported() -> bool;
+#endif
+} // namespace
+
+namespace seb_engine::simd
+{
+// x86-64 always has SSE2, which is all the SSE kernel uses
+auto detected_level() -> Level
+{
+#ifdef SE_SIMD_X86
+    static const auto level{ avx2_supported() ? Level::Avx2 : Level::Sse };
+
+    return level;
+#else
+    return Level::Scalar;
+#endif
+}
+
+auto level_name(const Level level) -> std::string_view
+{
+    switch (level)
+    {
+    case Level::Scalar:
+        return "scalar";
+    case Level::Sse:
+        return "SSE";
+    case Level::Avx2:
+        return "AVX2";
+    }
+
+    return "";
+}
+
+// pos[i] += vel[i] * dt for the elements the spans share
+auto integrate(const std::span<Pos> pos, const std::span<const Vel> vel, const float dt) -> void
+{
+    integrate(pos, vel, dt, detected_level());
+}
+
+// levels above the detected one fall back to it
+// every level multiplies then adds without fusing, so they all give bit identical results
+auto integrate(const std::span<Pos> pos, const std::span<const Vel> vel, const float dt, const Level level) -> void
+{
+    auto* const pos_floats{ reinterpret_cast<float*>(pos.data()) };             // NOLINT(*reinterpret-cast)
+    const auto* const vel_floats{ reinterpret_cast<const float*>(vel.data()) }; // NOLINT(*reinterpret-cast)
+    const auto count{ std::min(pos.size(), vel.size()) * 2 };
+    switch (std::min(level, detected_level()))
+    {
+    case Level::Scalar:
+        integrate_scalar(pos_floats, vel_floats, count, dt);
+        break;
+#ifdef SE_SIMD_X86
+    case Level::Sse:
+        integrate_sse(pos_floats, vel_floats, count, dt);
+        break;
+    case Level::Avx2:
+        integrate_avx2(pos_floats, vel_floats, count, dt);
+        break;
+#else
+    case Level::Sse:
+    case Level::Avx2:
+        break;
+#endif
+    }
+}
+} // namespace seb_engine::simd
+
+namespace
+{
+auto integrate_scalar(float* const pos, const float* const vel, const size_t count, const float dt) -> void
+{
+    for (size_t i{ 0 }; i < count; i++)
+    {
+        pos[i] += vel[i] * dt;
+    }
+}
+
+#ifdef SE_SIMD_X86
+auto integrate_sse(float* const pos, const float* const vel, const size_t count, const float dt) -> void
+{
+    constexpr size_t width{ 4 };
+    const auto dt_vec{ _mm_set1_ps(dt) };
+    size_t i{ 0 };
+    for (; i + width <= count; i += width)
+    {
+        const auto moved{ _mm_add_ps(_mm_loadu_ps(pos + i), _mm_mul_ps(_mm_loadu_ps(vel + i), dt_vec)) };
+        _mm_storeu_ps(pos + i, moved);
+    }
+
+    integrate_scalar(pos + i, vel + i, count - i, dt);
+}
+
+SE_TARGET_AVX2 auto integrate_avx2(float* const pos, const float* const vel, const size_t count, const float dt) -> void
+{
+    constexpr size_t width{ 8 };
+    const auto dt_vec{ _mm256_set1_ps(dt) };
+    size_t i{ 0 };
+    for (; i + width <= count; i += width)
+    {
+        const auto moved{ _mm256_add_ps(_mm256_loadu_ps(pos + i), _mm256_mul_ps(_mm256_loadu_ps(vel + i), dt_vec)) };
+        _mm256_storeu_ps(pos + i, moved);
+    }
+
+    integrate_sse(pos + i, vel + i, count - i, dt);
+}
+
+auto avx2_supported() -> bool
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    // AVX2 support is in bit 5 of ebx for leaf 7, and the OS has to save the wider registers, checked through xgetbv
+    constexpr int avx2_bit{ 1 << 5 };
+    constexpr int osxsave_bit{ 1 << 27 };
+    constexpr unsigned long long ymm_state{ 0x6 };
+    int info[4]{};
+    __cpuid(info, 1);
+    if ((info[2] & osxsave_bit) == 0 || (_xgetbv(0) & ymm_state) != ymm_state)
+    {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+
+    return (info[1] & avx2_bit) != 0;
+#else
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+} // namespace
@@ -0,0 +1,245 @@
+#include "se-snapshot.hpp"
+
+#include "sl-log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+namespace slog = seblib::log;
+
+inline constexpr std::array<char, 8> MAGIC{ 'S', 'E', 'B', 'S', 'N', 'A', 'P', '\0' };
+
+auto padded(const size_t size) -> size_t
+{
+    return (size + seb_engine::snapshot::SECTION_ALIGN - 1) / seb_engine::snapshot::SECTION_ALIGN
+        * seb_engine::snapshot::SECTION_ALIGN;
+}
+} // namespace
+
+namespace seb_engine::snapshot
+{
+Writer::Writer(const uint32_t version)
+{
+    const Header header{ .magic = MAGIC, .format_version = FORMAT_VERSION, .version = version };
+    m_buffer.resize(sizeof(Header));
+    std::memcpy(m_buffer.data(), &header, sizeof(Header));
+}
+
+// written beside the path and renamed over it, so a save which fails part way through never replaces the last good
+// snapshot with a truncated one
+auto Writer::save(std::filesystem::path const& path) const -> bool
+{
+    auto temp_path{ path };
+    temp_path += ".tmp";
+    std::ofstream file{ temp_path, std::ios::binary };
+    file.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+    file.close();
+    std::error_code error;
+    if (!file)
+    {
+        slog::log(slog::ERR, "Failed to write snapshot {}", temp_path.string());
+        std::filesystem::remove(temp_path, error);
+
+        return false;
+    }
+
+    std::filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        slog::log(slog::ERR, "Failed to replace snapshot {}, {}", path.string(), error.message());
+        std::filesystem::remove(temp_path, error);
+
+        return false;
+    }
+
+    slog::log(slog::TRC, "Wrote {} byte snapshot to {}", m_buffer.size(), path.string());
+
+    return true;
+}
+
+// returns where the section's data goes, padding is zeroed so snapshots of the same state are byte for byte identical
+auto Writer::section(const uint64_t count, const uint32_t element_size) -> std::byte*
+{
+    const SectionHeader header{ .count = count, .element_size = element_size, .padding = 0 };
+    const auto offset{ m_buffer.size() };
+    const auto size{ static_cast<size_t>(count) * element_size };
+    m_buffer.resize(offset + sizeof(SectionHeader) + padded(size), std::byte{ 0 });
+    std::memcpy(m_buffer.data() + offset, &header, sizeof(SectionHeader));
+
+    return m_buffer.data() + offset + sizeof(SectionHeader);
+}
+
+Reader::Reader(std::filesystem::path const& path, const uint32_t version)
+{
+#if defined(_WIN32) || defined(__CYGWIN__)
+    m_file = ::CreateFileW(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+    );
+    LARGE_INTEGER size{};
+    if (m_file == INVALID_HANDLE_VALUE || ::GetFileSizeEx(m_file, &size) == 0 || size.QuadPart == 0)
+    {
+        fail("could not open the file");
+        return;
+    }
+
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_mapping = ::CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping != nullptr)
+    {
+        m_data = static_cast<const std::byte*>(::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    const auto file{ ::open(path.c_str(), O_RDONLY) };
+    struct stat stats{};
+    if (file == -1 || ::fstat(file, &stats) == -1 || stats.st_size == 0)
+    {
+        if (file != -1)
+        {
+            ::close(file);
+        }
+
+        fail("could not open the file");
+        return;
+    }
+
+    m_size = static_cast<size_t>(stats.st_size);
+    auto* data{ ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0) };
+    // the mapping keeps the file open
+    ::close(file);
+    m_data = (data == MAP_FAILED ? nullptr : static_cast<const std::byte*>(data));
+#endif
+    if (m_data == nullptr)
+    {
+        fail("could not map the file");
+        return;
+    }
+
+    Header header{};
+    if (m_size < sizeof(Header))
+    {
+        fail("the file is too small");
+        return;
+    }
+
+    std::memcpy(&header, m_data, sizeof(Header));
+    if (header.magic != MAGIC)
+    {
+        fail("the file is not a snapshot");
+    }
+    else if (header.format_version != FORMAT_VERSION || header.version != version)
+    {
+        slog::log(
+            slog::ERR,
+            "Snapshot is version {}.{}, expected {}.{}",
+            header.format_version,
+            header.version,
+            FORMAT_VERSION,
+            version
+        );
+        fail("the version does not match");
+    }
+
+    m_offset = sizeof(Header);
+}
+
+Reader::~Reader()
+{
+    unmap();
+}
+
+auto Reader::fail(const std::string_view reason) -> void
+{
+    if (m_ok)
+    {
+        slog::log(slog::ERR, "Failed to load snapshot, {}", reason);
+    }
+
+    m_ok = false;
+}
+
+auto Reader::ok() const -> bool
+{
+    return m_ok;
+}
+
+// the section's data, or nothing if it doesn't hold elements of the expected size or runs past the end of the file
+auto Reader::section(const uint32_t element_size) -> std::span<const std::byte>
+{
+    if (!m_ok)
+    {
+        return {};
+    }
+
+    SectionHeader header{};
+    if (m_size - m_offset < sizeof(SectionHeader))
+    {
+        fail("the file ends early");
+        return {};
+    }
+
+    std::memcpy(&header, m_data + m_offset, sizeof(SectionHeader));
+    const auto size{ header.count * header.element_size };
+    const auto data_offset{ m_offset + sizeof(SectionHeader) };
+    if (header.element_size != element_size)
+    {
+        slog::log(slog::ERR, "Snapshot section holds {} byte elements, expected {}", header.element_size, element_size);
+        fail("a section does not match");
+        return {};
+    }
+
+    if (header.count > (m_size - data_offset) / std::max(element_size, uint32_t{ 1 }))
+    {
+        fail("the file ends early");
+        return {};
+    }
+
+    m_offset = std::min(data_offset + padded(size), m_size);
+
+    return { m_data + data_offset, size };
+}
+
+auto Reader::unmap() -> void
+{
+#if defined(_WIN32) || defined(__CYGWIN__)
+    if (m_data != nullptr)
+    {
+        ::UnmapViewOfFile(m_data);
+    }
+
+    if (m_mapping != nullptr)
+    {
+        ::CloseHandle(m_mapping);
+    }
+
+    if (m_file != nullptr && m_file != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(m_file);
+    }
+#else
+    if (m_data != nullptr)
+    {
+        ::munmap(const_cast<std::byte*>(m_data), m_size); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    }
+#endif
+    m_data = nullptr;
+}
+} // namespace seb_engine::snapshot
@@ -0,0 +1,86 @@
+#include "se-spatial.hpp"
+
+#include "sl-math.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace seb_engine
+{
+SpatialHash::SpatialHash(const float cell_size)
+    : m_cell_size{ cell_size }
+{
+}
+
+auto SpatialHash::clear() -> void
+{
+    m_inserted.clear();
+    m_entries.clear();
+    m_bucket_starts.clear();
+}
+
+// only found by queries once built
+auto SpatialHash::insert(const size_t value, const rl::Rectangle bounds) -> void
+{
+    const auto range{ cell_range(bounds) };
+    for (auto x{ range.min_x }; x <= range.max_x; x++)
+    {
+        for (auto y{ range.min_y }; y <= range.max_y; y++)
+        {
+            m_inserted.push_back({ .value = value, .x = x, .y = y, .range = range });
+        }
+    }
+}
+
+// counting sort of the entries into their buckets, which keeps the order they were inserted in within a bucket
+// there are at least twice as many buckets as entries, so few cells end up sharing one
+auto SpatialHash::build() -> void
+{
+    const auto bucket_count{ std::bit_ceil(std::max(m_inserted.size() * 2, size_t{ 1 })) };
+    m_bucket_starts.assign(bucket_count + 1, 0);
+    for (auto const& entry : m_inserted)
+    {
+        m_bucket_starts[bucket(entry.x, entry.y) + 1]++;
+    }
+
+    for (size_t i{ 1 }; i <= bucket_count; i++)
+    {
+        m_bucket_starts[i] += m_bucket_starts[i - 1];
+    }
+
+    // each start is moved along as its bucket fills, leaving it at the start of the next bucket
+    m_entries.resize(m_inserted.size());
+    for (auto const& entry : m_inserted)
+    {
+        m_entries[m_bucket_starts[bucket(entry.x, entry.y)]++] = entry;
+    }
+
+    for (auto i{ bucket_count }; i > 0; i--)
+    {
+        m_bucket_starts[i] = m_bucket_starts[i - 1];
+    }
+
+    m_bucket_starts[0] = 0;
+}
+
+auto SpatialHash::cell_range(const rl::Rectangle bounds) const -> CellRange
+{
+    return {
+        .min_x = static_cast<int32_t>(std::floor(bounds.x / m_cell_size)),
+        .min_y = static_cast<int32_t>(std::floor(bounds.y / m_cell_size)),
+        .max_x = static_cast<int32_t>(std::floor((bounds.x + bounds.width) / m_cell_size)),
+        .max_y = static_cast<int32_t>(std::floor((bounds.y + bounds.height) / m_cell_size)),
+    };
+}
+
+// the bucket count is a power of two, so the hash wraps with a mask
+auto SpatialHash::bucket(const int32_t x, const int32_t y) const -> size_t
+{
+    const auto hash{ (static_cast<uint32_t>(x) * 73856093U) ^ (static_cast<uint32_t>(y) * 19349663U) }; // NOLINT
+
+    return hash & (m_bucket_starts.size() - 2);
+}
+} // namespace seb_engine
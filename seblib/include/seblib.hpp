@@ -3,6 +3,8 @@
 
 #include "raylib-cpp.hpp" // IWYU pragma: keep
 
+#include <concepts>
+#include <cstddef>
 #include <cstdlib>
 #include <type_traits>
 #include <variant>
@@ -22,6 +24,10 @@ concept Enumerable = std::is_enum_v<Enum> || std::is_scoped_enum_v<Enum>;
 // taken from https://www.reddit.com/r/cpp/comments/16lq63k/2_lines_of_code_and_3_c17_features_the_overload
 template <typename Var, typename... Funcs>
 auto match(Var&& variant, Funcs&&... funcs);
+
+// position of T in Ts, fails to compile if T is not in Ts
+template <typename T, typename... Ts>
+consteval auto index_of() -> size_t;
 } // namespace seblib
 
 /****************************
@@ -37,6 +43,17 @@ auto match(Var&& variant, Funcs&&... funcs)
 {
     return std::visit(Overload{ std::forward<Funcs>(funcs)... }, std::forward<Var>(variant));
 }
+
+template <typename T, typename... Ts>
+consteval auto index_of() -> size_t
+{
+    static_assert((std::same_as<T, Ts> || ...), "Type is not in parameter pack");
+
+    size_t index{ 0 };
+    ((std::same_as<T, Ts> ? false : (index++, true)) && ...);
+
+    return index;
+}
 } // namespace seblib
 
 #endif
@@ -0,0 +1,61 @@
+#ifndef SL_ALLOC_HPP_
+#define SL_ALLOC_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// the global new and delete are only replaced when SL_ALLOC_TRACK is defined, otherwise SL_ALLOC_ALLOW compiles to
+// nothing
+// the replacements live in whichever module links sl-alloc.cpp in first, so a hot reloaded library reads its own,
+// unused counters
+#define SL_ALLOC_CONCAT_IMPL(a, b) a##b
+#define SL_ALLOC_CONCAT(a, b) SL_ALLOC_CONCAT_IMPL(a, b)
+#ifdef SL_ALLOC_TRACK
+// allocations on this thread for the rest of the enclosing scope are expected, so aren't counted against the frame
+#define SL_ALLOC_ALLOW() const seblib::alloc::Allow SL_ALLOC_CONCAT(sl_alloc_allow_, __LINE__)
+#else
+#define SL_ALLOC_ALLOW() static_cast<void>(0)
+#endif
+
+namespace seblib::alloc
+{
+struct FrameStats
+{
+    size_t allocations{ 0 };
+    size_t frees{ 0 };
+    size_t bytes{ 0 };
+};
+
+// where sampled allocations were made from, as the address operator new returns to, which addr2line can resolve
+struct Site
+{
+    uintptr_t address{ 0 };
+    size_t allocations{ 0 };
+    size_t bytes{ 0 };
+};
+
+class Allow
+{
+public:
+    Allow();
+    Allow(Allow const&) = delete;
+    Allow(Allow&&) = delete;
+    auto operator=(Allow const&) -> Allow& = delete;
+    auto operator=(Allow&&) -> Allow& = delete;
+    ~Allow();
+};
+
+// returns what the frame allocated, from any thread, since the last call
+auto end_frame() -> FrameStats;
+// while strict, allocating outside an allowed scope logs its size and call site then aborts, so a debugger stops on
+// the allocation
+auto set_strict(bool strict) -> void;
+// one in every interval allocations has its call site recorded, 1 records them all
+auto set_sample_interval(size_t interval) -> void;
+// most allocations first, allocates so should be called from an allowed scope
+[[nodiscard]] auto sites(size_t count) -> std::vector<Site>;
+auto clear_sites() -> void;
+} // namespace seblib::alloc
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef SL_JOBS_HPP_
+#define SL_JOBS_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace seblib::jobs
+{
+using Job = std::function<void()>;
+
+class Counter;
+class Pool;
+
+// a job along with the counter to decrement once it finishes
+struct Task
+{
+    Job job;
+    Counter* counter{ nullptr };
+};
+
+// number of jobs submitted against it which have yet to finish
+// jobs can be made to depend on a counter, in which case they are only queued once it reaches zero
+// a counter must outlive every job submitted against it, which waiting on it guarantees
+class Counter
+{
+public:
+    Counter() = default;
+    Counter(Counter const&) = delete;
+    Counter(Counter&&) = delete;
+    auto operator=(Counter const&) -> Counter& = delete;
+    auto operator=(Counter&&) -> Counter& = delete;
+    ~Counter() = default;
+
+    [[nodiscard]] auto done() const -> bool;
+
+    friend class Pool;
+
+private:
+    // the count is only touched while locked, so a waiter can't see zero and destroy the counter while the job that
+    // finished last is still releasing its dependents
+    mutable std::mutex m_mutex;
+    size_t m_count{ 0 };
+    std::vector<Task> m_dependents;
+};
+
+// work stealing thread pool, each worker pops the newest job from its own queue and steals the oldest job from the
+// others when it runs out
+// queues are ring buffers sized up front, so queueing a job doesn't allocate once the pool is built
+// threads waiting on a counter run jobs until it reaches zero rather than blocking, so waiting from inside a job can't
+// deadlock the pool, and a pool with no workers runs everything on the waiting thread
+class Pool
+{
+public:
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY{ 1024 };
+
+    explicit Pool(size_t workers = default_workers(), size_t queue_capacity = DEFAULT_QUEUE_CAPACITY);
+    Pool(Pool const&) = delete;
+    Pool(Pool&&) = delete;
+    auto operator=(Pool const&) -> Pool& = delete;
+    auto operator=(Pool&&) -> Pool& = delete;
+    ~Pool();
+
+    auto submit(Job job, Counter* counter = nullptr) -> void;
+    auto submit_after(Counter& dependency, Job job, Counter* counter = nullptr) -> void;
+    auto wait(Counter const& counter) -> void;
+    auto reserve(size_t jobs) -> void;
+    template <typename Func>
+    auto parallel_for(size_t begin, size_t end, size_t grain, Func&& func) -> void;
+    [[nodiscard]] auto worker_count() const -> size_t;
+    [[nodiscard]] static auto default_workers() -> size_t;
+
+private:
+    // the oldest task sits at head, and a full queue doubles in size rather than dropping tasks
+    struct Queue
+    {
+        std::mutex mutex;
+        std::vector<Task> tasks;
+        size_t head{ 0 };
+        size_t count{ 0 };
+
+        explicit Queue(size_t capacity);
+
+        auto push_back(Task task) -> void;
+        [[nodiscard]] auto pop_back() -> Task;
+        [[nodiscard]] auto pop_front() -> Task;
+        auto grow(size_t capacity) -> void;
+    };
+
+    // the last queue takes jobs submitted from threads outside the pool
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::jthread> m_workers;
+    // jobs sitting in queues, lets idle workers sleep until there is something to steal
+    std::atomic<size_t> m_queued{ 0 };
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake;
+    bool m_stop{ false };
+
+    auto push(Task task) -> void;
+    [[nodiscard]] auto pop() -> std::optional<Task>;
+    [[nodiscard]] auto queue_index() const -> size_t;
+    auto run(Task& task) -> void;
+    auto work(size_t index) -> void;
+};
+} // namespace seblib::jobs
+
+/****************************
+ *                          *
+ * TEMPLATE IMPLEMENTATIONS *
+ *                          *
+ ****************************/
+
+namespace seblib::jobs
+{
+// calls func(first, last) for consecutive ranges of at most grain indices covering [begin, end), returning once every
+// range is done
+// the calling thread runs ranges too, so the grain should be large enough for a range to outweigh queueing a job
+// each job only captures a reference and its first index, so fits in the job's small buffer rather than allocating
+template <typename Func>
+auto Pool::parallel_for(const size_t begin, const size_t end, const size_t grain, Func&& func) -> void
+{
+    const struct
+    {
+        Func& func;
+        size_t step;
+        size_t end;
+    } range{ .func = func, .step = std::max(grain, size_t{ 1 }), .end = end };
+    Counter counter;
+    for (auto first{ begin }; first < end; first += range.step)
+    {
+        submit([&range, first]() { range.func(first, std::min(first + range.step, range.end)); }, &counter);
+    }
+
+    wait(counter);
+}
+} // namespace seblib::jobs
+
+#endif
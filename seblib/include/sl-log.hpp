@@ -2,10 +2,12 @@
 #define SL_LOG_HPP_
 
 #include <cstdint>
-#include <filesystem>
 #include <format>
 #include <iostream>
+#include <iterator>
 #include <source_location>
+#include <string>
+#include <string_view>
 
 namespace seblib::log
 {
@@ -44,8 +46,6 @@ auto set_level(Level level) -> void;
 
 namespace seblib::log
 {
-namespace fs = std::filesystem;
-
 inline constexpr unsigned FILENAME_WIDTH{ 16 };
 
 template <typename... Args>
@@ -58,7 +58,7 @@ log<Args...>::log(
         return;
     }
 
-    std::string level_text;
+    std::string_view level_text;
     switch (lvl)
     {
     case FTL:
@@ -78,15 +78,14 @@ log<Args...>::log(
         break;
     }
 
-    const auto filename{ fs::path(loc.file_name()).filename().string() };
-    std::clog
-        << "["
-        << level_text
-        << "] "
-        << std::format("{:>{}}", filename, FILENAME_WIDTH)
-        << std::format(" {:>5}: ", loc.line())
-        << std::format(fmt, std::forward<Args>(args)...)
-        << "\n";
+    // the file name is cut out of the path in place, rather than building a path to take it from
+    const std::string_view path{ loc.file_name() };
+    const auto filename{ path.substr(path.find_last_of("/\\") + 1) };
+    // written in one go so lines logged from different threads don't interleave
+    auto line{ std::format("[{}] {:>{}} {:>5}: ", level_text, filename, FILENAME_WIDTH, loc.line()) };
+    std::format_to(std::back_inserter(line), fmt, std::forward<Args>(args)...);
+    line += '\n';
+    std::clog << line;
 
     if (lvl == FTL)
     {
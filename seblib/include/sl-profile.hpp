@@ -0,0 +1,66 @@
+#ifndef SL_PROFILE_HPP_
+#define SL_PROFILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+// zones are only recorded when SL_PROFILE is defined, otherwise SL_PROFILE_ZONE and SL_PROFILE_FRAME compile to
+// nothing
+#define SL_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SL_PROFILE_CONCAT(a, b) SL_PROFILE_CONCAT_IMPL(a, b)
+#ifdef SL_PROFILE
+// times the rest of the enclosing scope, name must outlive the profiler, which string literals do
+#define SL_PROFILE_ZONE(name) const seblib::profile::Zone SL_PROFILE_CONCAT(sl_profile_zone_, __LINE__){ name }
+// marks the end of a frame, called once per frame from the thread running the frame
+#define SL_PROFILE_FRAME() seblib::profile::end_frame()
+#else
+#define SL_PROFILE_ZONE(name) static_cast<void>(0)
+#define SL_PROFILE_FRAME() static_cast<void>(0)
+#endif
+
+namespace seblib::profile
+{
+// times are in nanoseconds since the profiler started
+struct Event
+{
+    std::string_view name;
+    int64_t start_ns{ 0 };
+    int64_t end_ns{ 0 };
+};
+
+// a zone's time per frame, summed over every time it ran in the frame on any thread
+struct ZoneStats
+{
+    std::string_view name;
+    double mean_ms{ 0.0 };
+    double max_ms{ 0.0 };
+};
+
+// records an event from construction to destruction into the calling thread's ring buffer
+// each thread keeps the most recent events, older ones are overwritten once the buffer wraps
+class Zone
+{
+public:
+    explicit Zone(std::string_view name);
+    Zone(Zone const&) = delete;
+    Zone(Zone&&) = delete;
+    auto operator=(Zone const&) -> Zone& = delete;
+    auto operator=(Zone&&) -> Zone& = delete;
+    ~Zone();
+
+private:
+    std::string_view m_name;
+    int64_t m_start_ns;
+};
+
+// reading events races with threads recording them, so frame_stats and write_chrome_trace should be called between
+// frames, while no other thread is running zones
+auto end_frame() -> void;
+[[nodiscard]] auto frame_stats(size_t frames) -> std::vector<ZoneStats>;
+[[nodiscard]] auto write_chrome_trace(std::filesystem::path const& path) -> bool;
+} // namespace seblib::profile
+
+#endif
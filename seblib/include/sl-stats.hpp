@@ -0,0 +1,24 @@
+#ifndef SL_STATS_HPP_
+#define SL_STATS_HPP_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace seblib::stats
+{
+// in the units of the samples it was made from
+struct Summary
+{
+    double mean{ 0.0 };
+    double median{ 0.0 };
+    double p99{ 0.0 };
+    double max{ 0.0 };
+};
+
+[[nodiscard]] auto summarise(std::vector<double> samples) -> Summary;
+// quoted and escaped, to be written into json as a string
+[[nodiscard]] auto json_string(std::string_view string) -> std::string;
+} // namespace seblib::stats
+
+#endif
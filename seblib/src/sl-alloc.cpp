@@ -0,0 +1,348 @@
+#include "sl-alloc.hpp"
+
+#include "sl-log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <tuple>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SL_ALLOC_RETURN_ADDRESS() reinterpret_cast<uintptr_t>(_ReturnAddress())
+#else
+#define SL_ALLOC_RETURN_ADDRESS() reinterpret_cast<uintptr_t>(__builtin_return_address(0))
+#endif
+
+namespace slog = seblib::log;
+
+namespace
+{
+// a power of two so probing wraps with a mask
+inline constexpr size_t SITE_CAPACITY{ 1024 };
+inline constexpr size_t DEFAULT_SAMPLE_INTERVAL{ 64 };
+
+// filled in without locking, as the hooks may run on any thread and can't allocate
+struct SiteSlot
+{
+    std::atomic<uintptr_t> address{ 0 };
+    std::atomic<size_t> allocations{ 0 };
+    std::atomic<size_t> bytes{ 0 };
+};
+
+// plain globals rather than function statics, so the hooks never wait on a guard while the runtime is starting up
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<size_t> frame_allocations{ 0 };
+std::atomic<size_t> frame_frees{ 0 };
+std::atomic<size_t> frame_bytes{ 0 };
+std::atomic<size_t> total_allocations{ 0 };
+std::atomic<size_t> sample_interval{ DEFAULT_SAMPLE_INTERVAL };
+std::atomic<bool> strict{ false };
+std::array<SiteSlot, SITE_CAPACITY> site_slots;
+thread_local size_t allow_depth{ 0 };
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+} // namespace
+
+namespace seblib::alloc
+{
+Allow::Allow()
+{
+    allow_depth++;
+}
+
+Allow::~Allow()
+{
+    allow_depth--;
+}
+
+auto end_frame() -> FrameStats
+{
+    return {
+        .allocations = frame_allocations.exchange(0, std::memory_order_relaxed),
+        .frees = frame_frees.exchange(0, std::memory_order_relaxed),
+        .bytes = frame_bytes.exchange(0, std::memory_order_relaxed),
+    };
+}
+
+auto set_strict(const bool is_strict) -> void
+{
+    strict.store(is_strict, std::memory_order_relaxed);
+}
+
+auto set_sample_interval(const size_t interval) -> void
+{
+    sample_interval.store(std::max(interval, size_t{ 1 }), std::memory_order_relaxed);
+}
+
+auto sites(const size_t count) -> std::vector<Site>
+{
+    std::vector<Site> found;
+    for (auto const& slot : site_slots)
+    {
+        const auto address{ slot.address.load(std::memory_order_acquire) };
+        if (address != 0)
+        {
+            found.push_back({ .address = address,
+                              .allocations = slot.allocations.load(std::memory_order_relaxed),
+                              .bytes = slot.bytes.load(std::memory_order_relaxed) });
+        }
+    }
+
+    std::ranges::sort(found, std::ranges::greater{}, [](Site const& site) { return site.allocations; });
+    found.resize(std::min(found.size(), count));
+
+    return found;
+}
+
+// races with sampling on other threads, so should be called between frames
+auto clear_sites() -> void
+{
+    for (auto& slot : site_slots)
+    {
+        slot.allocations.store(0, std::memory_order_relaxed);
+        slot.bytes.store(0, std::memory_order_relaxed);
+        slot.address.store(0, std::memory_order_release);
+    }
+}
+} // namespace seblib::alloc
+
+#ifdef SL_ALLOC_TRACK
+namespace
+{
+// sites are found by probing from the address' hash, and dropped once the table fills up
+auto sample(const size_t size, const uintptr_t address) -> void
+{
+    const auto hash{ (address >> 4U) * 0x9E3779B97F4A7C15ULL }; // NOLINT(*magic-numbers)
+    for (size_t probe{ 0 }; probe < SITE_CAPACITY; probe++)
+    {
+        auto& slot{ site_slots[(hash + probe) & (SITE_CAPACITY - 1)] };
+        auto expected{ slot.address.load(std::memory_order_acquire) };
+        if (expected == 0 && slot.address.compare_exchange_strong(expected, address, std::memory_order_acq_rel))
+        {
+            expected = address;
+        }
+
+        if (expected == address)
+        {
+            slot.allocations.fetch_add(1, std::memory_order_relaxed);
+            slot.bytes.fetch_add(size, std::memory_order_relaxed);
+
+            return;
+        }
+    }
+}
+
+auto record_allocation(const size_t size, const uintptr_t address) -> void
+{
+    if (allow_depth > 0)
+    {
+        return;
+    }
+
+    if (strict.load(std::memory_order_relaxed))
+    {
+        const seblib::alloc::Allow allow;
+        slog::log(slog::ERR, "Allocated {} bytes from {:#x} during a frame which may not allocate", size, address);
+        std::abort();
+    }
+
+    frame_allocations.fetch_add(1, std::memory_order_relaxed);
+    frame_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (total_allocations.fetch_add(1, std::memory_order_relaxed) % sample_interval.load(std::memory_order_relaxed)
+        == 0)
+    {
+        sample(size, address);
+    }
+}
+
+auto record_free(void* ptr) -> void
+{
+    if (ptr != nullptr && allow_depth == 0)
+    {
+        frame_frees.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// zero byte allocations still have to return a unique pointer
+auto try_allocate(const size_t size, const std::align_val_t align) -> void*
+{
+    const auto alignment{ static_cast<size_t>(align) };
+    const auto bytes{ std::max(size, size_t{ 1 }) };
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        return std::malloc(bytes); // NOLINT(*no-malloc, *owning-memory)
+    }
+
+#ifdef _WIN32
+    return _aligned_malloc(bytes, alignment);
+#else
+    // aligned_alloc needs the size to be a multiple of the alignment
+    return std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment);
+#endif
+}
+
+auto allocate(const size_t size, const std::align_val_t align) -> void*
+{
+    auto* ptr{ try_allocate(size, align) };
+    while (ptr == nullptr)
+    {
+        const auto handler{ std::get_new_handler() };
+        if (handler == nullptr)
+        {
+            throw std::bad_alloc{};
+        }
+
+        handler();
+        ptr = try_allocate(size, align);
+    }
+
+    return ptr;
+}
+
+auto deallocate(void* ptr, const std::align_val_t align) -> void
+{
+    record_free(ptr);
+#ifdef _WIN32
+    if (static_cast<size_t>(align) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        _aligned_free(ptr);
+
+        return;
+    }
+#else
+    std::ignore = align;
+#endif
+
+    std::free(ptr); // NOLINT(*no-malloc, *owning-memory)
+}
+
+inline constexpr auto DEFAULT_ALIGN{ static_cast<std::align_val_t>(__STDCPP_DEFAULT_NEW_ALIGNMENT__) };
+} // namespace
+
+// NOLINTBEGIN(*new-delete-overloads)
+auto operator new(const size_t size) -> void*
+{
+    record_allocation(size, SL_ALLOC_RETURN_ADDRESS());
+
+    return allocate(size, DEFAULT_ALIGN);
+}
+
+auto operator new[](const size_t size) -> void*
+{
+    record_allocation(size, SL_ALLOC_RETURN_ADDRESS());
+
+    return allocate(size, DEFAULT_ALIGN);
+}
+
+auto operator new(const size_t size, const std::align_val_t align) -> void*
+{
+    record_allocation(size, SL_ALLOC_RETURN_ADDRESS());
+
+    return allocate(size, align);
+}
+
+auto operator new[](const size_t size, const std::align_val_t align) -> void*
+{
+    record_allocation(size, SL_ALLOC_RETURN_ADDRESS());
+
+    return allocate(size, align);
+}
+
+auto operator new(const size_t size, std::nothrow_t const&) noexcept -> void*
+{
+    record_allocation(size, SL_ALLOC_RETURN_ADDRESS());
+
+    return try_allocate(size, DEFAULT_ALIGN);
+}
+
+auto operator new[](const size_t size, std::nothrow_t const&) noexcept -> void*
+{
+    record_allocation(size, SL_ALLOC_RETURN_ADDRESS());
+
+    return try_allocate(size, DEFAULT_ALIGN);
+}
+
+auto operator new(const size_t size, const std::align_val_t align, std::nothrow_t const&) noexcept -> void*
+{
+    record_allocation(size, SL_ALLOC_RETURN_ADDRESS());
+
+    return try_allocate(size, align);
+}
+
+auto operator new[](const size_t size, const std::align_val_t align, std::nothrow_t const&) noexcept -> void*
+{
+    record_allocation(size, SL_ALLOC_RETURN_ADDRESS());
+
+    return try_allocate(size, align);
+}
+
+auto operator delete(void* ptr) noexcept -> void
+{
+    deallocate(ptr, DEFAULT_ALIGN);
+}
+
+auto operator delete[](void* ptr) noexcept -> void
+{
+    deallocate(ptr, DEFAULT_ALIGN);
+}
+
+auto operator delete(void* ptr, size_t) noexcept -> void
+{
+    deallocate(ptr, DEFAULT_ALIGN);
+}
+
+auto operator delete[](void* ptr, size_t) noexcept -> void
+{
+    deallocate(ptr, DEFAULT_ALIGN);
+}
+
+auto operator delete(void* ptr, const std::align_val_t align) noexcept -> void
+{
+    deallocate(ptr, align);
+}
+
+auto operator delete[](void* ptr, const std::align_val_t align) noexcept -> void
+{
+    deallocate(ptr, align);
+}
+
+auto operator delete(void* ptr, size_t, const std::align_val_t align) noexcept -> void
+{
+    deallocate(ptr, align);
+}
+
+auto operator delete[](void* ptr, size_t, const std::align_val_t align) noexcept -> void
+{
+    deallocate(ptr, align);
+}
+
+auto operator delete(void* ptr, std::nothrow_t const&) noexcept -> void
+{
+    deallocate(ptr, DEFAULT_ALIGN);
+}
+
+auto operator delete[](void* ptr, std::nothrow_t const&) noexcept -> void
+{
+    deallocate(ptr, DEFAULT_ALIGN);
+}
+
+auto operator delete(void* ptr, const std::align_val_t align, std::nothrow_t const&) noexcept -> void
+{
+    deallocate(ptr, align);
+}
+
+auto operator delete[](void* ptr, const std::align_val_t align, std::nothrow_t const&) noexcept -> void
+{
+    deallocate(ptr, align);
+}
+// NOLINTEND(*new-delete-overloads)
+#endif
@@ -0,0 +1,276 @@
+#include "sl-jobs.hpp"
+
+#include "sl-log.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace slog = seblib::log;
+
+namespace
+{
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+thread_local seblib::jobs::Pool const* t_pool{ nullptr };
+thread_local size_t t_queue_index{ 0 };
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+} // namespace
+
+namespace seblib::jobs
+{
+auto Counter::done() const -> bool
+{
+    const std::scoped_lock lock{ m_mutex };
+
+    return m_count == 0;
+}
+
+Pool::Pool(const size_t workers, const size_t queue_capacity)
+{
+    for (size_t i{ 0 }; i <= workers; i++)
+    {
+        m_queues.push_back(std::make_unique<Queue>(queue_capacity));
+    }
+
+    for (size_t i{ 0 }; i < workers; i++)
+    {
+        m_workers.emplace_back([this, i]() { work(i); });
+    }
+}
+
+// queued jobs are finished before the workers stop
+Pool::~Pool()
+{
+    {
+        const std::scoped_lock lock{ m_sleep_mutex };
+        m_stop = true;
+    }
+
+    m_wake.notify_all();
+    m_workers.clear();
+}
+
+auto Pool::submit(Job job, Counter* const counter) -> void
+{
+    if (counter != nullptr)
+    {
+        const std::scoped_lock lock{ counter->m_mutex };
+        counter->m_count++;
+    }
+
+    push({ .job = std::move(job), .counter = counter });
+}
+
+// the job is queued straight away if the dependency has already reached zero
+auto Pool::submit_after(Counter& dependency, Job job, Counter* const counter) -> void
+{
+    if (counter != nullptr)
+    {
+        const std::scoped_lock lock{ counter->m_mutex };
+        counter->m_count++;
+    }
+
+    Task task{ .job = std::move(job), .counter = counter };
+    {
+        const std::scoped_lock lock{ dependency.m_mutex };
+        if (dependency.m_count != 0)
+        {
+            dependency.m_dependents.push_back(std::move(task));
+
+            return;
+        }
+    }
+
+    push(std::move(task));
+}
+
+auto Pool::wait(Counter const& counter) -> void
+{
+    while (!counter.done())
+    {
+        auto task{ pop() };
+        if (task.has_value())
+        {
+            run(task.value());
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// grows every queue to hold at least the given number of jobs, so a burst of that size can be queued without
+// allocating
+auto Pool::reserve(const size_t jobs) -> void
+{
+    for (auto& queue : m_queues)
+    {
+        const std::scoped_lock lock{ queue->mutex };
+        if (queue->tasks.size() < jobs)
+        {
+            queue->grow(jobs);
+        }
+    }
+}
+
+auto Pool::worker_count() const -> size_t
+{
+    return m_workers.size();
+}
+
+// leaves a core for the thread submitting jobs, which runs them while it waits
+auto Pool::default_workers() -> size_t
+{
+    const auto threads{ std::thread::hardware_concurrency() };
+
+    return (threads > 1 ? threads - 1 : 0);
+}
+
+auto Pool::push(Task task) -> void
+{
+    auto& queue{ *m_queues[queue_index()] };
+    {
+        const std::scoped_lock lock{ queue.mutex };
+        queue.push_back(std::move(task));
+    }
+
+    m_queued++;
+    {
+        // taking the lock orders this with a worker checking m_queued before it sleeps, so the wake up isn't lost
+        const std::scoped_lock lock{ m_sleep_mutex };
+    }
+
+    m_wake.notify_one();
+}
+
+// the thread's own queue is popped newest first, other queues are stolen from oldest first
+auto Pool::pop() -> std::optional<Task>
+{
+    if (m_queued == 0)
+    {
+        return std::nullopt;
+    }
+
+    const auto own_index{ queue_index() };
+    for (size_t offset{ 0 }; offset < m_queues.size(); offset++)
+    {
+        const auto index{ (own_index + offset) % m_queues.size() };
+        auto& queue{ *m_queues[index] };
+        const std::scoped_lock lock{ queue.mutex };
+        if (queue.count == 0)
+        {
+            continue;
+        }
+
+        auto task{ (index == own_index ? queue.pop_back() : queue.pop_front()) };
+        m_queued--;
+
+        return task;
+    }
+
+    return std::nullopt;
+}
+
+auto Pool::queue_index() const -> size_t
+{
+    return (t_pool == this ? t_queue_index : m_queues.size() - 1);
+}
+
+auto Pool::run(Task& task) -> void
+{
+    task.job();
+    if (task.counter == nullptr)
+    {
+        return;
+    }
+
+    std::vector<Task> dependents;
+    {
+        const std::scoped_lock lock{ task.counter->m_mutex };
+        task.counter->m_count--;
+        if (task.counter->m_count == 0)
+        {
+            std::swap(dependents, task.counter->m_dependents);
+        }
+    }
+
+    for (auto& dependent : dependents)
+    {
+        push(std::move(dependent));
+    }
+}
+
+auto Pool::work(const size_t index) -> void
+{
+    t_pool = this;
+    t_queue_index = index;
+    while (true)
+    {
+        auto task{ pop() };
+        if (task.has_value())
+        {
+            run(task.value());
+            continue;
+        }
+
+        std::unique_lock lock{ m_sleep_mutex };
+        m_wake.wait(lock, [this]() { return m_stop || m_queued > 0; });
+        if (m_stop && m_queued == 0)
+        {
+            return;
+        }
+    }
+}
+
+Pool::Queue::Queue(const size_t capacity)
+    : tasks(std::max(capacity, size_t{ 1 }))
+{
+}
+
+// growing allocates, which is logged so the capacity can be raised or reserved before the frames that need it
+auto Pool::Queue::push_back(Task task) -> void
+{
+    if (count == tasks.size())
+    {
+        grow(tasks.size() * 2);
+        slog::log(slog::WRN, "Job queue was full, grew it to {} jobs", tasks.size());
+    }
+
+    tasks[(head + count) % tasks.size()] = std::move(task);
+    count++;
+}
+
+auto Pool::Queue::pop_back() -> Task
+{
+    count--;
+
+    return std::move(tasks[(head + count) % tasks.size()]);
+}
+
+auto Pool::Queue::pop_front() -> Task
+{
+    auto task{ std::move(tasks[head]) };
+    head = (head + 1) % tasks.size();
+    count--;
+
+    return task;
+}
+
+// moves the queued tasks to the start of the new buffer, oldest first
+auto Pool::Queue::grow(const size_t capacity) -> void
+{
+    std::vector<Task> grown(capacity);
+    for (size_t i{ 0 }; i < count; i++)
+    {
+        grown[i] = std::move(tasks[(head + i) % tasks.size()]);
+    }
+
+    tasks = std::move(grown);
+    head = 0;
+}
+} // namespace seblib::jobs
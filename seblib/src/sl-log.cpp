@@ -1,5 +1,6 @@
 #include "sl-log.hpp"
 
+#include <atomic>
 #include <cstdlib>
 
 #ifndef SLOG_LVL
@@ -10,19 +11,20 @@ using namespace seblib::log;
 
 namespace
 {
-// this will need to change if doing any multithreading
-Level log_level{ static_cast<Level>(SLOG_LVL) }; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+// atomic as logging can happen from any thread
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<Level> log_level{ static_cast<Level>(SLOG_LVL) };
 } // namespace
 
 namespace seblib::log
 {
 auto level() -> int
 {
-    return log_level;
+    return log_level.load(std::memory_order_relaxed);
 }
 
 auto set_level(const Level level) -> void
 {
-    log_level = level;
+    log_level.store(level, std::memory_order_relaxed);
 }
 } // namespace seblib::log
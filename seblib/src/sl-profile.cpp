@@ -0,0 +1,226 @@
+#include "sl-profile.hpp"
+
+#include "sl-alloc.hpp"
+#include "sl-log.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace slog = seblib::log;
+
+namespace
+{
+// per thread, a power of two so the write position wraps with a mask
+inline constexpr size_t EVENT_CAPACITY{ 1 << 15 };
+inline constexpr size_t FRAME_CAPACITY{ 1024 };
+
+struct ThreadBuffer
+{
+    std::vector<seblib::profile::Event> events = std::vector<seblib::profile::Event>(EVENT_CAPACITY);
+    // total events ever written, the oldest of which have been overwritten once it passes the capacity
+    std::atomic<size_t> written{ 0 };
+    size_t thread_index{ 0 };
+};
+
+// buffers are never freed, so events recorded by threads which have since exited can still be read
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    // when each of the most recent frames ended
+    std::vector<int64_t> frame_ends = std::vector<int64_t>(FRAME_CAPACITY);
+    size_t frame_count{ 0 };
+};
+
+auto registry() -> Registry&;
+auto now_ns() -> int64_t;
+auto thread_buffer() -> ThreadBuffer&;
+template <typename Func>
+auto each_event(ThreadBuffer const& buffer, Func&& func) -> void;
+} // namespace
+
+namespace seblib::profile
+{
+Zone::Zone(const std::string_view name)
+    : m_name{ name }
+    , m_start_ns{ now_ns() }
+{
+}
+
+Zone::~Zone()
+{
+    auto& buffer{ thread_buffer() };
+    const auto written{ buffer.written.load(std::memory_order_relaxed) };
+    buffer.events[written & (EVENT_CAPACITY - 1)] = Event{ .name = m_name, .start_ns = m_start_ns, .end_ns = now_ns() };
+    buffer.written.store(written + 1, std::memory_order_release);
+}
+
+auto end_frame() -> void
+{
+    auto& reg{ registry() };
+    const std::scoped_lock lock{ reg.mutex };
+    reg.frame_ends[reg.frame_count % FRAME_CAPACITY] = now_ns();
+    reg.frame_count++;
+}
+
+// covers the last frames completed, fewer if not that many have been recorded
+// a zone is counted in the frame it ended in, and zones which straddle the start of the first frame are left out
+auto frame_stats(const size_t frames) -> std::vector<ZoneStats>
+{
+    auto& reg{ registry() };
+    const std::scoped_lock lock{ reg.mutex };
+    // a window of frame_count frames needs a boundary more than that
+    const auto boundaries{ std::min(reg.frame_count, FRAME_CAPACITY) };
+    const auto frame_count{ std::min(frames, boundaries - std::min(boundaries, size_t{ 1 })) };
+    if (frame_count == 0)
+    {
+        return {};
+    }
+
+    // frame_ends[i + 1] is when frame i of the window ended, with frame_ends[0] being the start of the window
+    std::vector<int64_t> frame_ends;
+    for (auto frame{ reg.frame_count - frame_count - 1 }; frame < reg.frame_count; frame++)
+    {
+        frame_ends.push_back(reg.frame_ends[frame % FRAME_CAPACITY]);
+    }
+
+    std::map<std::string_view, std::vector<double>> frame_times;
+    for (auto const& buffer : reg.buffers)
+    {
+        each_event(
+            *buffer,
+            [&](Event const& event)
+            {
+                if (event.start_ns < frame_ends.front() || event.end_ns > frame_ends.back())
+                {
+                    return;
+                }
+
+                const auto frame{ std::ranges::lower_bound(frame_ends, event.end_ns) - frame_ends.begin() - 1 };
+                auto& times{ frame_times[event.name] };
+                times.resize(frame_count);
+                times[static_cast<size_t>(std::max(frame, std::ptrdiff_t{ 0 }))]
+                    += static_cast<double>(event.end_ns - event.start_ns) / 1.0e6; // NOLINT(*magic-numbers)
+            }
+        );
+    }
+
+    std::vector<ZoneStats> stats;
+    for (auto const& [name, times] : frame_times)
+    {
+        double total{ 0.0 };
+        for (const auto time : times)
+        {
+            total += time;
+        }
+
+        stats.push_back({ .name = name,
+                          .mean_ms = total / static_cast<double>(frame_count),
+                          .max_ms = std::ranges::max(times) });
+    }
+
+    std::ranges::sort(stats, std::ranges::greater{}, [](ZoneStats const& zone) { return zone.mean_ms; });
+
+    return stats;
+}
+
+// complete events, one track per thread, with times in microseconds as the format expects
+// zone names are assumed to be plain identifiers, so are written without escaping
+auto write_chrome_trace(std::filesystem::path const& path) -> bool
+{
+    auto& reg{ registry() };
+    const std::scoped_lock lock{ reg.mutex };
+    std::ofstream file{ path };
+    file << "{\"traceEvents\":[";
+    auto first{ true };
+    size_t event_count{ 0 };
+    for (auto const& buffer : reg.buffers)
+    {
+        each_event(
+            *buffer,
+            [&](Event const& event)
+            {
+                file << std::format(
+                    R"({}{{"name":"{}","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":0,"tid":{}}})",
+                    first ? "\n" : ",\n",
+                    event.name,
+                    static_cast<double>(event.start_ns) / 1.0e3, // NOLINT(*magic-numbers)
+                    static_cast<double>(event.end_ns - event.start_ns) / 1.0e3, // NOLINT(*magic-numbers)
+                    buffer->thread_index
+                );
+                first = false;
+                event_count++;
+            }
+        );
+    }
+
+    file << "\n]}\n";
+    if (!file)
+    {
+        slog::log(slog::ERR, "Failed to write trace to {}", path.string());
+
+        return false;
+    }
+
+    slog::log(slog::INF, "Wrote {} zones to trace {}", event_count, path.string());
+
+    return true;
+}
+} // namespace seblib::profile
+
+namespace
+{
+auto registry() -> Registry&
+{
+    static Registry reg;
+
+    return reg;
+}
+
+auto now_ns() -> int64_t
+{
+    static const auto start{ std::chrono::steady_clock::now() };
+    const std::chrono::nanoseconds elapsed{ std::chrono::steady_clock::now() - start };
+
+    return elapsed.count();
+}
+
+// registered on the thread's first zone, which may come after allocation tracking has warmed up
+auto thread_buffer() -> ThreadBuffer&
+{
+    thread_local ThreadBuffer* buffer{ nullptr };
+    if (buffer == nullptr)
+    {
+        SL_ALLOC_ALLOW();
+        auto& reg{ registry() };
+        const std::scoped_lock lock{ reg.mutex };
+        auto& registered{ reg.buffers.emplace_back(std::make_unique<ThreadBuffer>()) };
+        registered->thread_index = reg.buffers.size() - 1;
+        buffer = registered.get();
+    }
+
+    return *buffer;
+}
+
+// oldest first
+template <typename Func>
+auto each_event(ThreadBuffer const& buffer, Func&& func) -> void
+{
+    const auto written{ buffer.written.load(std::memory_order_acquire) };
+    for (auto i{ written - std::min(written, EVENT_CAPACITY) }; i < written; i++)
+    {
+        func(buffer.events[i & (EVENT_CAPACITY - 1)]);
+    }
+}
+} // namespace
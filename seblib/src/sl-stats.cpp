@@ -0,0 +1,60 @@
+#include "sl-stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace seblib::stats
+{
+// the p99 is the nearest rank, so takes the largest sample when there are fewer than 100
+auto summarise(std::vector<double> samples) -> Summary
+{
+    if (samples.empty())
+    {
+        return {};
+    }
+
+    std::ranges::sort(samples);
+    const auto count{ samples.size() };
+    const auto middle{ count / 2 };
+    const auto p99_rank{ static_cast<size_t>(std::ceil(static_cast<double>(count) * 0.99)) }; // NOLINT(*magic-numbers)
+
+    return {
+        .mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(count),
+        .median = (count % 2 == 0 ? (samples[middle - 1] + samples[middle]) / 2 : samples[middle]),
+        .p99 = samples[std::max(p99_rank, size_t{ 1 }) - 1],
+        .max = samples.back(),
+    };
+}
+
+// names are plain text, so only quotes, backslashes and control characters need escaping
+auto json_string(const std::string_view string) -> std::string
+{
+    std::string escaped{ "\"" };
+    for (const auto c : string)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) // NOLINT(*magic-numbers)
+        {
+            escaped += std::format("\\u{:04x}", static_cast<unsigned>(c));
+        }
+        else
+        {
+            escaped += c;
+        }
+    }
+
+    escaped += '"';
+
+    return escaped;
+}
+} // namespace seblib::stats
@@ -3,15 +3,27 @@
 #include "components.hpp"
 #include "entities.hpp"
 #include "se-bbox.hpp"
+#include "se-prefab.hpp"
+#include "se-scheduler.hpp"
+#include "se-snapshot.hpp"
+#include "sl-alloc.hpp"
 #include "sl-extern.hpp"
 #include "sl-log.hpp"
 #include "sl-math.hpp"
+#include "sl-profile.hpp"
 #include "sprites.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cmath>
+#include <filesystem>
 #include <optional>
 #include <ranges>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
 
 namespace rl = raylib;
 namespace sl = seblib;
@@ -19,8 +31,7 @@ namespace slog = seblib::log;
 namespace sm = seblib::math;
 namespace se = seb_engine;
 namespace sui = seb_engine::ui;
-
-inline constexpr unsigned TARGET_FPS{ 60 };
+namespace views = std::views;
 
 inline constexpr float LINE_ANGLE_SPACING{ 5.0 };
 inline constexpr float PROJECTILE_RADIUS{ 4.0 };
@@ -42,26 +53,43 @@ inline constexpr se::BBoxCircle PROJECTILE_BBOX{ PROJECTILE_RADIUS };
 
 namespace
 {
+using EnemyPrefab = se::Prefab<Entity, std::tuple<se::Pos, se::BBox, Combat>, std::tuple<SpriteBase>>;
+using ProjectilePrefab = se::Prefab<Entity, std::tuple<se::Pos, se::Vel, se::BBox, Combat>, std::tuple<SpriteBase>>;
+using DamageLinePrefab = se::Prefab<Entity, std::tuple<se::Pos, Combat>>;
+
+auto simulation_scheduler() -> se::Scheduler<Game>;
+auto enemy_prefab(Enemy enemy) -> EnemyPrefab;
+auto projectile_prefab(float lifespan, unsigned damage) -> ProjectilePrefab;
+auto damage_line_prefab(rl::Vector2 source_pos, unsigned damage) -> DamageLinePrefab;
 auto pause_screen(Game& game) -> sui::Screen;
-auto spawn_melee(Game& game, rl::Vector2 source_pos, size_t parent_id) -> void;
-auto spawn_projectile(Game& game, rl::Vector2 source_pos, rl::Vector2 target_pos) -> void;
-auto spawn_sector(Game& game, rl::Vector2 source_pos, rl::Vector2 target_pos, size_t parent_id) -> void;
+auto init_melee(Game& game, size_t id, MeleeSpawn const& melee) -> void;
+auto init_projectile(Game& game, size_t id, ProjectileSpawn const& projectile) -> void;
+auto init_sector(Game& game, size_t id, SectorSpawn const& sector) -> void;
 auto spawn_sector_lines(
     Game& game, unsigned line_count, rl::Vector2 source_pos, rl::Vector2 target_pos, size_t sector_id
 ) -> void;
 } // namespace
 
-Game::Game()
+Game::Game(const Mode mode, const size_t max_entities)
+    : entities{ max_entities }
+    , mode{ mode }
 {
-    window.SetTargetFPS(TARGET_FPS);
-    window.SetExitKey(::KEY_NULL);
+    if (mode == Mode::Windowed)
+    {
+        window.Init(sui::WINDOW_WIDTH, sui::WINDOW_HEIGHT, WINDOW_TITLE);
+        window.SetTargetFPS(TARGET_FPS);
+        window.SetExitKey(::KEY_NULL);
+        texture_sheet.Load(TEXTURE_SHEET);
+    }
 
-    components.reg<se::Pos>();
-    components.reg<se::Vel>();
-    components.reg<se::BBox>();
-    components.reg<Flags>();
-    components.reg<Combat>();
-    components.reg<Parent>();
+    // move queues a job per page, the most any system queues in a tick
+    jobs.reserve((max_entities + se::PAGE_SIZE - 1) / se::PAGE_SIZE);
+    components.reg<Combat>(se::Storage::Sparse);
+    components.reg<Parent>(se::Storage::Sparse);
+    flipped_vel_changes = components.track<se::Vel>();
+    children_pos_changes = components.track<se::Pos>();
+    children_flags_changes = components.track<Flags>();
+    children_parent_changes = components.track<Parent>();
 
     for (size_t i{ 0 }; i < 10; i++) // NOLINT
     {
@@ -89,31 +117,113 @@ Game::Game()
 
 auto Game::run() -> void
 {
-    // input
-    poll_inputs();
+#ifdef SL_ALLOC_TRACK
+    begin_alloc_frame();
+#endif
+
+    {
+        SL_PROFILE_ZONE("poll_inputs");
+        poll_inputs();
+    }
+
+    if (rl::Keyboard::IsKeyPressed(::KEY_F5))
+    {
+        std::ignore = save_snapshot(QUICKSAVE_FILE);
+    }
+    else if (rl::Keyboard::IsKeyPressed(::KEY_F9))
+    {
+        std::ignore = load_snapshot(QUICKSAVE_FILE);
+    }
+
+#ifdef SL_PROFILE
+    if (rl::Keyboard::IsKeyPressed(::KEY_F3))
+    {
+        show_profile = !show_profile;
+    }
+    else if (rl::Keyboard::IsKeyPressed(::KEY_F4))
+    {
+        SL_ALLOC_ALLOW();
+        std::ignore = seblib::profile::write_chrome_trace(TRACE_FILE);
+    }
+#endif
+
+    update(frame_dt());
+    render();
+    SL_PROFILE_FRAME();
+#ifdef SL_ALLOC_TRACK
+    end_alloc_frame();
+#endif
+}
+
+// runs a frame on the given inputs, a frame time of dt() runs a single tick
+auto Game::run_headless(Inputs const& frame_inputs, const float frame_time) -> void
+{
+#ifdef SL_ALLOC_TRACK
+    begin_alloc_frame();
+#endif
+
+    inputs = frame_inputs;
+    update(frame_time);
+    SL_PROFILE_FRAME();
+#ifdef SL_ALLOC_TRACK
+    end_alloc_frame();
+#endif
+}
+
+// handles the frame's inputs, then runs as many ticks as the frame time covers
+auto Game::update(const float frame_time) -> void
+{
+    SL_PROFILE_ZONE("update");
+    if (recorder != std::nullopt)
+    {
+        recorder->record(inputs, frame_time);
+    }
+
     check_pause_game();
     ui_interaction();
-    if (!paused)
+    if (paused)
+    {
+        // clicks are held until a tick consumes them, so ones made while paused are discarded
+        inputs.left_click = false;
+        inputs.right_click = false;
+    }
+    else
     {
-        // movement
-        set_player_vel();
-        move();
-        resolve_tile_collisions();
-        set_flipped();
-        sync_children();
+        accumulator += frame_time;
+        const auto pending_ticks{ std::min(accumulator / dt(), static_cast<float>(MAX_TICKS_PER_FRAME)) };
+        const auto ticks{ static_cast<unsigned>(pending_ticks) };
+        for (unsigned i{ 0 }; i < ticks; i++)
+        {
+            // only the positions before the last tick are needed for interpolation, and only when rendering
+            if (i == ticks - 1 && mode == Mode::Windowed)
+            {
+                save_prev_positions();
+            }
+
+            tick();
+            accumulator -= dt();
+        }
 
-        // combat
-        player_action();
-        update_invuln_times();
-        damage_entities();
-        update_lifespans();
-        destroy_entities();
+        if (accumulator >= dt())
+        {
+            const auto remainder{ std::fmod(accumulator, dt()) };
+            slog::log(slog::TRC, "Dropping {}s of simulation time", accumulator - remainder);
+            accumulator = remainder;
+        }
     }
 
-    // render
+    if (inputs.spawn_enemy)
+    {
+        spawn_enemy(Enemy::Duck, Coords{ 6, 6 }); // NOLINT
+    }
+}
+
+auto Game::render() -> void
+{
+    SL_PROFILE_ZONE("render");
     window.BeginDrawing();
     window.ClearBackground(::SKYBLUE);
-    camera.SetTarget(components.get<se::Pos>(player_id) + (SPRITE_SIZE / 2));
+    camera.SetTarget(render_pos(player_id) + (SPRITE_SIZE / 2));
     camera.BeginMode();
     render_damage_lines();
     render_sprites();
@@ -126,59 +236,121 @@ auto Game::run() -> void
 
     camera.EndMode();
     render_ui();
+#ifdef SL_PROFILE
+    render_profile();
+#endif
+
     window.EndDrawing();
+}
 
-    if (inputs.spawn_enemy)
+// one fixed step of the simulation
+auto Game::tick() -> void
+{
+    // built once per library load, as it holds pointers to this library's systems
+    static const auto scheduler{ simulation_scheduler() };
+    SL_PROFILE_ZONE("tick");
+    scheduler.run(*this, jobs, (time_systems ? &system_times : nullptr));
+    const auto commands_start{ std::chrono::steady_clock::now() };
     {
-        spawn_enemy(Enemy::Duck, Coords{ 6, 6 }); // NOLINT
+        SL_PROFILE_ZONE("apply_commands");
+        apply_commands();
+    }
+
+    if (time_systems)
+    {
+        const auto time{ std::chrono::steady_clock::now() - commands_start };
+        system_times.push_back({ .name = "apply_commands", .time = time });
     }
+
+    inputs.left_click = false;
+    inputs.right_click = false;
+}
+
+// grows everything indexed by id along with the entities, returns NO_ENTITY if the entity can't be spawned
+auto Game::spawn(const Entity type) -> size_t
+{
+    const auto id{ entities.spawn(type) };
+    grow_storage();
+
+    return id;
+}
+
+auto Game::grow_storage() -> void
+{
+    const auto capacity{ entities.capacity() };
+    components.resize(capacity);
+    sprites.resize(capacity);
+    hierarchy.resize(capacity);
 }
 
 auto Game::spawn_player(const Coords coords) -> void
 {
-    const auto id{ entities.spawn(Entity::Player) };
+    const auto id{ spawn(Entity::Player) };
+    if (id == se::NO_ENTITY)
+    {
+        slog::log(slog::ERR, "Couldn't spawn the player");
+        return;
+    }
+
     player_id = id;
     auto comps{ components.by_id(id) };
-    comps.get<se::Pos>() = coords;
-    comps.get<se::BBox>() = se::BBox{ PLAYER_CBOX_SIZE, PLAYER_CBOX_OFFSET };
-    auto& combat{ comps.get<Combat>() };
+    comps.add<se::Pos>() = coords;
+    comps.add<se::Vel>();
+    comps.add<se::BBox>() = se::BBox{ PLAYER_CBOX_SIZE, PLAYER_CBOX_OFFSET };
+    comps.add<Flags>();
+    auto& combat{ comps.add<Combat>() };
     combat.health.set(PLAYER_HEALTH);
     combat.hitbox = se::BBox{ PLAYER_HITBOX_SIZE, PLAYER_HITBOX_OFFSET };
 }
 
-auto Game::spawn_enemy(const Enemy enemy, const Coords coords) -> void
+// may grow entity and component storage
+auto Game::spawn_enemy(const Enemy enemy, const Coords coords, const size_t count) -> void
 {
-    auto sprite_base{ SpriteBase::None };
-    switch (enemy)
-    {
-    case Enemy::Duck:
-        sprite_base = SpriteBase::EnemyDuck;
-        break;
-    }
-
-    const auto id{ entities.spawn(Entity::Enemy) };
-    slog::log(slog::TRC, "Spawning enemy with id {}", id);
-    auto comps{ components.by_id(id) };
-    comps.get<se::Pos>() = coords;
-    comps.get<se::BBox>() = se::BBox{ ENEMY_CBOX_SIZE, ENEMY_CBOX_OFFSET };
-    auto& combat{ comps.get<Combat>() };
-    combat.health.set(ENEMY_HEALTH);
-    combat.hitbox = se::BBox{ ENEMY_HITBOX_SIZE, ENEMY_HITBOX_OFFSET };
-    sprites.set(id, sprite_base);
+    auto prefab{ enemy_prefab(enemy) };
+    std::get<se::Pos>(prefab.comps) = coords;
+    auto const& ids{ spawn_batch(prefab, count, [](size_t, size_t) {}) };
+    slog::log(slog::TRC, "Spawned {} enemies", ids.size());
 }
 
+// the simulation always steps by the same amount, so results don't depend on the frame rate
 auto Game::dt() const -> float
+{
+    return 1.0F / static_cast<float>(TICK_RATE);
+}
+
+// for animations, which advance once per rendered frame
+auto Game::frame_dt() const -> float
 {
     return window.GetFrameTime();
 }
 
-auto Game::mouse_world_pos() const -> sm::Vec2
+// interpolates between the positions before and after the last tick, by how far through the next tick the frame is
+// entities spawned since the last tick are drawn where they are
+auto Game::render_pos(const size_t id) const -> se::Pos
 {
-    const auto pos{ camera.GetScreenToWorld(rl::Mouse::GetPosition()) - SPRITE_SIZE / 2 };
+    const auto pos{ components.get<se::Pos>(id) };
+    if (id >= prev_positions.size() || !entities.valid(prev_positions[id].handle))
+    {
+        return pos;
+    }
 
-    return { pos.x, pos.y };
+    const auto prev_pos{ prev_positions[id].pos };
+
+    return prev_pos + (pos - prev_pos) * (accumulator / dt());
+}
+
+auto Game::save_prev_positions() -> void
+{
+    // only live ids are snapshotted, entries left over from destroyed entities fail the handle check in render_pos
+    auto const& positions{ std::as_const(components) };
+    prev_positions.resize(entities.capacity());
+    for (const auto id : components.ids<se::Pos>())
+    {
+        prev_positions[id] = PrevPos{ .handle = entities.handle(id), .pos = positions.get<se::Pos>(id) };
+    }
 }
 
+// destroys the entity's children along with it
 auto Game::destroy_entity(const size_t id) -> void
 {
     if (entities.vec()[id] == Entity::None)
@@ -186,40 +358,71 @@ auto Game::destroy_entity(const size_t id) -> void
         return;
     }
 
-    entities.destroy(id);
-    components.uninit(id);
-    sprites.unset(id);
-    for (const auto [child_id, parent] : components.vec<Parent>() | std::views::enumerate)
-    {
-        if (parent.id != std::nullopt && parent.id.value() == id)
+    hierarchy.destroy(
+        id,
+        [this](const size_t destroyed_id)
         {
-            destroy_entity(child_id);
+            entities.destroy(destroyed_id);
+            components.uninit(destroyed_id);
+            sprites.unset(destroyed_id);
         }
+    );
+}
+
+// the parent may have been destroyed since the child was requested, in which case the child is left unattached and
+// only keeps the stale handle
+auto Game::set_parent(const size_t id, const se::EntityHandle parent) -> void
+{
+    components.add<Parent>(id).id = parent;
+    if (entities.valid(parent))
+    {
+        hierarchy.attach(id, parent.id);
     }
 }
 
+// only the attack's position and direction are recorded, the rest is looked up from its details once it is spawned
 auto Game::spawn_attack(const Attack attack, const size_t parent_id) -> void
 {
     const auto source_pos{ components.get<se::Pos>(parent_id) };
     slog::log(slog::TRC, "Attack source pos ({}, {})", source_pos.x, source_pos.y);
-    const auto target_pos{ (parent_id == player_id ? mouse_world_pos() : components.get<se::Pos>(player_id)) };
+    const auto target_pos{ (parent_id == player_id ? inputs.mouse_world_pos : components.get<se::Pos>(player_id)) };
     slog::log(slog::TRC, "Attack target pos ({}, {})", target_pos.x, target_pos.y);
+    const auto parent{ entities.handle(parent_id) };
     switch (attack)
     {
     case Attack::Melee:
-        spawn_melee(*this, source_pos, parent_id);
+        commands.spawn(Entity::Melee, MeleeSpawn{ .source_pos = source_pos, .parent = parent });
         break;
     case Attack::Projectile:
-        spawn_projectile(*this, source_pos, target_pos);
+    {
+        const auto diff{ static_cast<rl::Vector2>(target_pos) - static_cast<rl::Vector2>(source_pos) };
+        const auto angle{ std::atan2(diff.y, diff.x) };
+        const auto speed{ std::get<ProjectileDetails>(entities::attack_details(Attack::Projectile).details).speed };
+        const auto vel{ rl::Vector2{ std::cos(angle), std::sin(angle) } * speed };
+        commands.spawn(Entity::Projectile, ProjectileSpawn{ .source_pos = source_pos, .vel = vel });
         break;
+    }
     case Attack::Sector:
-        spawn_sector(*this, source_pos, target_pos, parent_id);
+        commands.spawn(
+            Entity::Sector, SectorSpawn{ .source_pos = source_pos, .target_pos = target_pos, .parent = parent }
+        );
         break;
     }
 }
 
+auto Game::init_attack(const size_t id, AttackSpawn const& spawn) -> void
+{
+    sl::match(
+        spawn,
+        [this, id](MeleeSpawn const& melee) { init_melee(*this, id, melee); },
+        [this, id](ProjectileSpawn const& projectile) { init_projectile(*this, id, projectile); },
+        [this, id](SectorSpawn const& sector) { init_sector(*this, id, sector); }
+    );
+}
+
 auto Game::toggle_pause() -> void
 {
+    SL_ALLOC_ALLOW();
     paused = !paused;
     if (paused)
     {
@@ -233,6 +436,110 @@ auto Game::toggle_pause() -> void
     }
 }
 
+// saved between frames, so there are never commands waiting to be applied
+auto Game::save_snapshot(std::filesystem::path const& path) const -> bool
+{
+    SL_ALLOC_ALLOW();
+    se::snapshot::Writer writer{ SNAPSHOT_VERSION };
+    world.save(writer);
+    entities.save(writer);
+    components.save(writer);
+    hierarchy.save(writer);
+    sprites.save(writer);
+    writer.write_value(player_id);
+    if (!writer.save(path))
+    {
+        return false;
+    }
+
+    slog::log(slog::INF, "Saved snapshot {}", path.string());
+
+    return true;
+}
+
+// every section is read and checked before any of the game is replaced, so a snapshot which fails to load leaves the
+// game as it was
+auto Game::load_snapshot(std::filesystem::path const& path) -> bool
+{
+    SL_ALLOC_ALLOW();
+    se::snapshot::Reader reader{ path, SNAPSHOT_VERSION };
+    const auto world_sections{ world.read(reader) };
+    const auto entity_sections{ entities.read(reader) };
+    const auto capacity{ entity_sections.entities.size() };
+    const auto component_sections{ components.read(reader, entity_sections.entities) };
+    const auto hierarchy_sections{ hierarchy.read(reader, entity_sections.entities) };
+    const auto sprite_sections{ sprites.read(reader, capacity) };
+    const auto loaded_player_id{ reader.read_value<size_t>() };
+    if (reader.ok() && (loaded_player_id >= capacity || entity_sections.entities[loaded_player_id] != Entity::Player))
+    {
+        reader.fail("the player does not exist");
+    }
+
+    if (!reader.ok())
+    {
+        return false;
+    }
+
+    world.load(world_sections);
+    entities.load(entity_sections);
+    components.load(component_sections);
+    hierarchy.load(hierarchy_sections);
+    sprites.load(sprite_sections);
+    player_id = loaded_player_id;
+    prev_positions.clear();
+    accumulator = 0.0;
+    slog::log(slog::INF, "Loaded snapshot {}", path.string());
+    if (recorder != std::nullopt)
+    {
+        recorder->record_load(path);
+    }
+
+    return true;
+}
+
+#ifdef SL_ALLOC_TRACK
+// once warmed up, debug builds abort on the first allocation a frame makes outside an allowed scope
+auto Game::begin_alloc_frame() -> void
+{
+#ifndef NDEBUG
+    seblib::alloc::set_strict(alloc_frames >= ALLOC_WARMUP_FRAMES);
+#endif
+}
+
+// warns about every warmed up frame which allocated, along with the sites sampled most often so far
+auto Game::end_alloc_frame() -> void
+{
+    seblib::alloc::set_strict(false);
+    SL_ALLOC_ALLOW();
+    const auto stats{ seblib::alloc::end_frame() };
+    alloc_frames++;
+    if (alloc_frames == ALLOC_WARMUP_FRAMES)
+    {
+        seblib::alloc::clear_sites();
+    }
+
+    if (alloc_frames <= ALLOC_WARMUP_FRAMES || stats.allocations == 0)
+    {
+        return;
+    }
+
+    slog::log(
+        slog::WRN,
+        "Frame {} made {} allocations of {} bytes and {} frees",
+        alloc_frames,
+        stats.allocations,
+        stats.bytes,
+        stats.frees
+    );
+    for (auto const& site : seblib::alloc::sites(ALLOC_REPORT_SITES))
+    {
+        slog::log(
+            slog::WRN, "{} sampled allocations of {} bytes from {:#x}", site.allocations, site.bytes, site.address
+        );
+    }
+}
+#endif
+
 #ifndef NDEBUG
 #include "hot-reload.hpp"
 
@@ -278,50 +585,135 @@ auto pause_screen(Game& game) -> sui::Screen
     return screen;
 }
 
-void spawn_melee(Game& game, const rl::Vector2 source_pos, const size_t parent_id)
+void init_melee(Game& game, const size_t id, MeleeSpawn const& melee)
 {
     const auto details{ entities::attack_details(Attack::Melee) };
     const auto melee_details{ std::get<MeleeDetails>(details.details) };
-    const auto id{ game.entities.spawn(Entity::Melee) };
     auto comps{ game.components.by_id(id) };
-    comps.get<se::Pos>() = source_pos;
-    auto& combat{ comps.get<Combat>() };
+    comps.add<se::Pos>() = melee.source_pos;
+    comps.add<Flags>();
+    auto& combat{ comps.add<Combat>() };
     combat.lifespan = details.lifespan;
     combat.hitbox = se::BBox{ melee_details.size, MELEE_OFFSET };
     combat.damage = details.damage;
-    comps.get<Parent>().id = parent_id;
+    game.set_parent(id, melee.parent);
 }
 
-void spawn_projectile(Game& game, const rl::Vector2 source_pos, const rl::Vector2 target_pos)
+// the window and camera are not modified while these systems run, so reading them is not declared
+// get and try_get never add components, so only spawning, set_parent and loading write signatures, none of which run
+// from these systems directly
+auto simulation_scheduler() -> se::Scheduler<Game>
+{
+    using se::Reads;
+    using se::Writes;
+    using Entities = se::Entities<Entity>;
+
+    se::Scheduler<Game> scheduler;
+    // movement
+    scheduler.add<Reads<Inputs, se::Signatures>, Writes<se::Vel>>("set_player_vel", &Game::set_player_vel);
+    scheduler.add<Reads<se::Vel, se::Signatures>, Writes<se::Pos>>("move", &Game::move);
+    scheduler.add<Reads<se::BBox, Game::World, se::Signatures>, Writes<se::Pos, CollisionScratch>>(
+        "resolve_tile_collisions", &Game::resolve_tile_collisions
+    );
+    scheduler.add<Reads<Entities, se::Signatures>, Writes<se::Vel, Flags>>("set_flipped", &Game::set_flipped);
+    scheduler.add<Reads<se::Hierarchy, Entities, se::Signatures>, Writes<se::Pos, Flags, Combat, Parent>>(
+        "sync_children", &Game::sync_children
+    );
+
+    // combat
+    scheduler.add<
+        Reads<Inputs, Entities, se::Pos, se::BBox, se::Signatures>,
+        Writes<Combat, Sprites, Game::World, Game::Commands>>("player_action", &Game::player_action);
+    scheduler.add<Reads<se::Signatures>, Writes<Combat>>("update_invuln_times", &Game::update_invuln_times);
+    scheduler.add<Reads<Entities, se::Pos, se::Signatures>, Writes<Combat, Game::Commands, HitScratch>>(
+        "damage_entities", &Game::damage_entities
+    );
+    scheduler.add<Reads<Entities, se::Signatures>, Writes<Combat, Game::Commands>>(
+        "update_lifespans", &Game::update_lifespans
+    );
+
+    const auto stages{ scheduler.stages() };
+    for (const auto [stage, names] : stages | views::enumerate)
+    {
+        std::string systems;
+        for (const auto name : names)
+        {
+            systems += (systems.empty() ? "" : ", ");
+            systems += name;
+        }
+
+        slog::log(slog::INF, "Simulation stage {}: {}", stage, systems);
+    }
+
+    return scheduler;
+}
+
+auto enemy_prefab(const Enemy enemy) -> EnemyPrefab
+{
+    auto sprite_base{ SpriteBase::None };
+    switch (enemy)
+    {
+    case Enemy::Duck:
+        sprite_base = SpriteBase::EnemyDuck;
+        break;
+    }
+
+    Combat combat;
+    combat.health.set(ENEMY_HEALTH);
+    combat.hitbox = se::BBox{ ENEMY_HITBOX_SIZE, ENEMY_HITBOX_OFFSET };
+
+    return {
+        .type = Entity::Enemy,
+        .comps = { se::Pos{}, se::BBox{ ENEMY_CBOX_SIZE, ENEMY_CBOX_OFFSET }, combat },
+        .sprite_parts = { sprite_base },
+    };
+}
+
+auto projectile_prefab(const float lifespan, const unsigned damage) -> ProjectilePrefab
+{
+    Combat combat;
+    combat.lifespan = lifespan;
+    combat.hitbox = se::BBox{ PROJECTILE_BBOX };
+    combat.damage = damage;
+
+    return {
+        .type = Entity::Projectile,
+        .comps = { se::Pos{}, se::Vel{}, se::BBox{ PROJECTILE_BBOX }, combat },
+        .sprite_parts = { SpriteBase::Projectile },
+    };
+}
+
+// the hitbox is set per line, as each line points in a different direction
+auto damage_line_prefab(const rl::Vector2 source_pos, const unsigned damage) -> DamageLinePrefab
+{
+    Combat combat;
+    combat.damage = damage;
+
+    return { .type = Entity::DamageLine, .comps = { se::Pos{ source_pos }, combat }, .sprite_parts = {} };
+}
+
+void init_projectile(Game& game, const size_t id, ProjectileSpawn const& projectile)
 {
-    const auto diff{ target_pos - source_pos };
-    const auto angle{ std::atan2(diff.y, diff.x) };
     const auto details{ entities::attack_details(Attack::Projectile) };
-    const auto proj_details{ std::get<ProjectileDetails>(details.details) };
-    const auto vel{ rl::Vector2{ std::cos(angle), std::sin(angle) } * proj_details.speed };
-    const auto id{ game.entities.spawn(Entity::Projectile) };
+    projectile_prefab(details.lifespan, details.damage).write(std::span{ &id, 1 }, game.components, game.sprites);
     auto comps{ game.components.by_id(id) };
-    comps.get<se::Pos>() = source_pos + (SPRITE_SIZE / 2) - rl::Vector2{ PROJECTILE_RADIUS, PROJECTILE_RADIUS };
-    comps.get<se::Vel>() = vel;
-    comps.get<se::BBox>() = se::BBox{ PROJECTILE_BBOX };
-    game.sprites.set(id, SpriteBase::Projectile);
-    auto& combat{ comps.get<Combat>() };
-    combat.lifespan = details.lifespan;
-    combat.hitbox = se::BBox{ PROJECTILE_BBOX };
-    combat.damage = details.damage;
+    comps.get<se::Pos>()
+        = projectile.source_pos + (SPRITE_SIZE / 2) - rl::Vector2{ PROJECTILE_RADIUS, PROJECTILE_RADIUS };
+    comps.get<se::Vel>() = projectile.vel;
 }
 
-void spawn_sector(Game& game, const rl::Vector2 source_pos, const rl::Vector2 target_pos, const size_t parent_id)
+void init_sector(Game& game, const size_t id, SectorSpawn const& sector)
 {
     const auto details{ entities::attack_details(Attack::Sector) };
     const auto sector_det{ std::get<SectorDetails>(details.details) };
     const auto line_count{ static_cast<size_t>(ceil(sector_det.radius * sector_det.angle / LINE_ANGLE_SPACING)) + 1 };
     slog::log(slog::TRC, "Spawning {} damage lines", line_count);
-    const auto sector_id{ game.entities.spawn(Entity::Sector) };
-    auto comps{ game.components.by_id(sector_id) };
-    comps.get<Combat>().lifespan = details.lifespan;
-    comps.get<Parent>().id = parent_id;
-    spawn_sector_lines(game, line_count, source_pos, target_pos, sector_id);
+    auto comps{ game.components.by_id(id) };
+    comps.add<se::Pos>() = sector.source_pos;
+    comps.add<Combat>().lifespan = details.lifespan;
+    game.set_parent(id, sector.parent);
+    // commands are being applied at this point, so the lines can be spawned directly
+    spawn_sector_lines(game, line_count, sector.source_pos, sector.target_pos, id);
 }
 
 void spawn_sector_lines(
@@ -341,20 +733,21 @@ void spawn_sector_lines(
     slog::log(slog::TRC, "Angle between damage lines: {}", sl::math::radians_to_degrees(angle_diff));
     const auto sector_offset{ (sm::Vec2{ std::cos(angle), std::sin(angle) } * sector_details.sector_offset)
                               + (SPRITE_SIZE / 2) };
-    for (size_t i{ 0 }; i < line_count; i++)
-    {
-        const auto line_id{ game.entities.spawn(Entity::DamageLine) };
-        const auto line_ang{ initial_angle + (angle_diff * static_cast<float>(i)) };
-        const auto offset{
-            sector_offset + sm::Vec2{ std::cos(line_ang), std::sin(line_ang) } * sector_details.line_offset
-        };
-        slog::log(slog::TRC, "Offsetting damage line by ({}, {})", offset.x, offset.y);
-        auto comps{ game.components.by_id(line_id) };
-        comps.get<se::Pos>() = source_pos;
-        auto& combat{ comps.get<Combat>() };
-        combat.hitbox = se::BBox{ se::BBoxLine{ sector_details.radius, line_ang }, offset };
-        combat.damage = details.damage;
-        comps.get<Parent>().id = sector_id;
-    }
+    const auto sector{ game.entities.handle(sector_id) };
+    game.spawn_batch(
+        damage_line_prefab(source_pos, details.damage),
+        line_count,
+        [&](const size_t line_id, const size_t i)
+        {
+            const auto line_ang{ initial_angle + (angle_diff * static_cast<float>(i)) };
+            const auto offset{
+                sector_offset + sm::Vec2{ std::cos(line_ang), std::sin(line_ang) } * sector_details.line_offset
+            };
+            slog::log(slog::TRC, "Offsetting damage line by ({}, {})", offset.x, offset.y);
+            game.components.get<Combat>(line_id).hitbox
+                = se::BBox{ se::BBoxLine{ sector_details.radius, line_ang }, offset };
+            game.set_parent(line_id, sector);
+        }
+    );
 }
 } // namespace
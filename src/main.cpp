@@ -1,4 +1,17 @@
 #include "game.hpp"
+#include "replay.hpp"
+#include "settings.hpp"
+#include "sl-log.hpp"
+#include "sl-profile.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
 
 #ifndef NDEBUG
 #include "hot-reload.hpp"
@@ -6,9 +19,91 @@
 namespace hr = hot_reload;
 #endif
 
-auto main() -> int
+namespace slog = seblib::log;
+
+namespace
+{
+// a minute of game time
+inline constexpr size_t DEFAULT_HEADLESS_TICKS{ 3600 };
+
+auto parse_count(std::string_view arg, std::string_view what) -> size_t;
+auto run_headless(size_t ticks, size_t max_entities) -> void;
+auto run_replay(std::filesystem::path const& path, size_t max_entities) -> void;
+} // namespace
+
+// pass --headless [ticks] to run the simulation without a window, as fast as it will go
+// pass --record <file> to record the inputs of a game, and --replay <file> to run them back headless at full speed
+// pass --load <file> to start from a snapshot saved with F5, which can follow --record <file> to record from it
+// pass --max-entities <count> before any of the above to change how many entities storage can grow to, replays have
+// to be given the count they were recorded with
+// profiling builds write the zones recorded during headless and replay runs to TRACE_FILE once they finish
+auto main(int argc, char* argv[]) -> int
 {
-    Game game;
+    std::span args{ argv, static_cast<size_t>(argc) };
+    auto max_entities{ MAX_ENTITIES };
+    if (args.size() > 1 && std::string_view{ args[1] } == "--max-entities")
+    {
+        if (args.size() < 3)
+        {
+            slog::log(slog::FTL, "--max-entities needs a count");
+        }
+
+        max_entities = parse_count(args[2], "entity count");
+        if (max_entities == 0)
+        {
+            slog::log(slog::FTL, "--max-entities needs a count above 0");
+        }
+
+        // drops the option, leaving the mode at args[1] as if it hadn't been given
+        args = args.subspan(2);
+    }
+
+    const std::string_view mode{ (args.size() > 1 ? args[1] : "") };
+    if ((mode == "--record" || mode == "--replay" || mode == "--load") && args.size() < 3)
+    {
+        slog::log(slog::FTL, "{} needs a file", mode);
+    }
+
+    if (mode == "--replay")
+    {
+        run_replay(args[2], max_entities);
+
+        return 0;
+    }
+
+    if (mode == "--headless")
+    {
+        const auto ticks{ (args.size() > 2 ? parse_count(args[2], "tick count") : DEFAULT_HEADLESS_TICKS) };
+        run_headless(ticks, max_entities);
+
+        return 0;
+    }
+
+    // the snapshot is loaded before recording starts, and stored in the recording as where it starts from
+    const auto load_index{ (mode == "--record" ? 3UZ : 1UZ) };
+    const auto load{ args.size() > load_index && std::string_view{ args[load_index] } == "--load" };
+    if (load && args.size() < load_index + 2)
+    {
+        slog::log(slog::FTL, "--load needs a file");
+    }
+
+    std::optional<std::filesystem::path> start;
+    if (load)
+    {
+        start = args[load_index + 1];
+    }
+
+    Game game{ Game::Mode::Windowed, max_entities };
+    if (start.has_value() && !game.load_snapshot(start.value()))
+    {
+        slog::log(slog::FTL, "Failed to load {}", start->string());
+    }
+
+    if (mode == "--record")
+    {
+        game.recorder.emplace(args[2], start);
+    }
+
 #ifndef NDEBUG
     GameFuncs game_funcs{ hr::reload_lib() };
     while (!game.close && !game.window.ShouldClose())
@@ -30,3 +125,78 @@ auto main() -> int
 
     return 0;
 }
+
+namespace
+{
+auto parse_count(const std::string_view arg, const std::string_view what) -> size_t
+{
+    size_t count{ 0 };
+    const auto [ptr, ec]{ std::from_chars(arg.data(), arg.data() + arg.size(), count) };
+    if (ec != std::errc{} || ptr != arg.data() + arg.size())
+    {
+        slog::log(slog::FTL, "Invalid {} {}", what, arg);
+    }
+
+    return count;
+}
+
+// no inputs are given, so the player stands still while the simulation runs
+auto run_headless(const size_t ticks, const size_t max_entities) -> void
+{
+    Game game{ Game::Mode::Headless, max_entities };
+    const auto start{ std::chrono::steady_clock::now() };
+    for (size_t i{ 0 }; i < ticks && !game.close; i++)
+    {
+        game.run_headless(Inputs{}, game.dt());
+    }
+
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+    slog::log(
+        slog::INF,
+        "Ran {} ticks in {:.3f}s ({:.0f} ticks/s)",
+        ticks,
+        elapsed.count(),
+        static_cast<double>(ticks) / elapsed.count()
+    );
+#ifdef SL_PROFILE
+    std::ignore = seblib::profile::write_chrome_trace(TRACE_FILE);
+#endif
+}
+
+// frames are run back to back, with the frame times they were recorded with
+// snapshots are loaded where the recording loaded them, so a replay which can't load one would diverge and stops
+auto run_replay(std::filesystem::path const& path, const size_t max_entities) -> void
+{
+    Game game{ Game::Mode::Headless, max_entities };
+    replay::Reader reader{ path };
+    if (reader.start().has_value() && !game.load_snapshot(reader.start().value()))
+    {
+        slog::log(slog::FTL, "Failed to load {}, which the recording starts from", reader.start()->string());
+    }
+
+    size_t frames{ 0 };
+    const auto start{ std::chrono::steady_clock::now() };
+    for (auto frame{ reader.next() }; frame != std::nullopt && !game.close; frame = reader.next())
+    {
+        if (frame->load.has_value() && !game.load_snapshot(frame->load.value()))
+        {
+            slog::log(slog::FTL, "Failed to load {}, which the recording loads", frame->load->string());
+        }
+
+        game.run_headless(frame->inputs, frame->frame_time);
+        frames++;
+    }
+
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+    slog::log(
+        slog::INF,
+        "Replayed {} frames in {:.3f}s ({:.0f} frames/s)",
+        frames,
+        elapsed.count(),
+        static_cast<double>(frames) / elapsed.count()
+    );
+#ifdef SL_PROFILE
+    std::ignore = seblib::profile::write_chrome_trace(TRACE_FILE);
+#endif
+}
+} // namespace
@@ -0,0 +1,336 @@
+#include "replay.hpp"
+
+#include "inputs.hpp"
+#include "settings.hpp"
+#include "sl-log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace slog = seblib::log;
+namespace sm = seblib::math;
+
+inline constexpr std::array MAGIC{ std::byte{ 'G' }, std::byte{ 'R' }, std::byte{ 'E' }, std::byte{ 'C' } };
+// version 2 added the starting snapshot and load records
+inline constexpr uint16_t VERSION{ 2 };
+inline constexpr size_t HEADER_SIZE{ MAGIC.size() + sizeof(uint16_t) * 3 };
+inline constexpr size_t FLUSH_SIZE{ 1 << 16 };
+
+namespace
+{
+// every record starts with its kind, a load applies to the frame after it
+enum Record : uint8_t
+{
+    FRAME = 0,
+    LOAD = 1,
+};
+
+enum Button : uint8_t
+{
+    LEFT = 1 << 0,
+    RIGHT = 1 << 1,
+    UP = 1 << 2,
+    DOWN = 1 << 3,
+    LEFT_CLICK = 1 << 4,
+    RIGHT_CLICK = 1 << 5,
+    SPAWN_ENEMY = 1 << 6,
+    PAUSE = 1 << 7,
+};
+
+auto pack_buttons(Inputs const& inputs) -> uint8_t;
+auto unpack_buttons(Inputs& inputs, uint8_t buttons) -> void;
+template <std::unsigned_integral T>
+auto write(std::vector<std::byte>& buffer, T value) -> void;
+auto write(std::vector<std::byte>& buffer, float value) -> void;
+auto write(std::vector<std::byte>& buffer, std::string_view value) -> void;
+template <std::unsigned_integral T>
+auto read(std::span<const std::byte> data, size_t& offset) -> T;
+auto read_float(std::span<const std::byte> data, size_t& offset) -> float;
+auto read_string(std::span<const std::byte> data, size_t& offset) -> std::optional<std::string>;
+} // namespace
+
+namespace replay
+{
+// the tick rate is stored, as a recording only reproduces the same run when replayed at the rate it was recorded at
+// the snapshot the game was started from is stored too, an empty name meaning the game started fresh
+Recorder::Recorder(std::filesystem::path const& path, std::optional<std::filesystem::path> const& start)
+    : m_path{ path }
+    , m_file{ path, std::ios::binary }
+{
+    if (!m_file)
+    {
+        slog::log(slog::FTL, "Failed to open {} for recording", path.string());
+    }
+
+    m_buffer.reserve(FLUSH_SIZE);
+    m_buffer.insert(m_buffer.end(), MAGIC.begin(), MAGIC.end());
+    write(m_buffer, VERSION);
+    write(m_buffer, static_cast<uint16_t>(TICK_RATE));
+    write(m_buffer, (start.has_value() ? copy_snapshot(start.value()) : std::string{}));
+    slog::log(slog::INF, "Recording inputs to {}", path.string());
+}
+
+Recorder::~Recorder()
+{
+    flush();
+}
+
+auto Recorder::record(Inputs const& inputs, const float frame_time) -> void
+{
+    write(m_buffer, static_cast<uint8_t>(FRAME));
+    write(m_buffer, pack_buttons(inputs));
+    write(m_buffer, frame_time);
+    if (inputs.left_click || inputs.right_click)
+    {
+        write(m_buffer, inputs.mouse_pos.x);
+        write(m_buffer, inputs.mouse_pos.y);
+        write(m_buffer, inputs.mouse_world_pos.x);
+        write(m_buffer, inputs.mouse_world_pos.y);
+    }
+
+    if (m_buffer.size() >= FLUSH_SIZE)
+    {
+        flush();
+    }
+}
+
+// called once the snapshot has loaded, so a load which failed and changed nothing isn't replayed
+auto Recorder::record_load(std::filesystem::path const& snapshot) -> void
+{
+    write(m_buffer, static_cast<uint8_t>(LOAD));
+    write(m_buffer, copy_snapshot(snapshot));
+}
+
+auto Recorder::flush() -> void
+{
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
+}
+
+// returns the name of the copy, which is looked for in the recording's directory when replaying
+auto Recorder::copy_snapshot(std::filesystem::path const& snapshot) -> std::string
+{
+    auto name{ std::format("{}.{}.snapshot", m_path.filename().string(), m_snapshots) };
+    m_snapshots++;
+    std::error_code error;
+    std::filesystem::copy_file(
+        snapshot, m_path.parent_path() / name, std::filesystem::copy_options::overwrite_existing, error
+    );
+    if (error)
+    {
+        slog::log(slog::ERR, "Failed to copy snapshot {} for the recording: {}", snapshot.string(), error.message());
+    }
+
+    return name;
+}
+
+Reader::Reader(std::filesystem::path const& path)
+{
+    std::ifstream file{ path, std::ios::binary | std::ios::ate };
+    if (!file)
+    {
+        slog::log(slog::FTL, "Failed to open recording {}", path.string());
+    }
+
+    m_data.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(m_data.data()), static_cast<std::streamsize>(m_data.size()));
+    if (m_data.size() < HEADER_SIZE || !std::ranges::equal(std::span{ m_data }.first(MAGIC.size()), MAGIC))
+    {
+        slog::log(slog::FTL, "{} is not a recording", path.string());
+    }
+
+    m_offset = MAGIC.size();
+    const auto version{ read<uint16_t>(m_data, m_offset) };
+    if (version != VERSION)
+    {
+        slog::log(slog::FTL, "Recording version {} is not supported, expected {}", version, VERSION);
+    }
+
+    const auto tick_rate{ read<uint16_t>(m_data, m_offset) };
+    if (tick_rate != TICK_RATE)
+    {
+        slog::log(slog::WRN, "Recording was made at {} ticks/s, replaying at {} ticks/s", tick_rate, TICK_RATE);
+    }
+
+    const auto start{ read_string(m_data, m_offset) };
+    if (start == std::nullopt)
+    {
+        slog::log(slog::FTL, "{} is not a recording", path.string());
+    }
+
+    m_dir = path.parent_path();
+    if (!start->empty())
+    {
+        m_start = m_dir / start.value();
+    }
+}
+
+// the snapshot to load before the first frame, if the game didn't start fresh
+auto Reader::start() const -> std::optional<std::filesystem::path> const&
+{
+    return m_start;
+}
+
+// returns nullopt at the end of the recording, a frame cut short by the recording stopping mid write is dropped
+auto Reader::next() -> std::optional<Frame>
+{
+    Frame frame;
+    while (m_offset < m_data.size() && static_cast<Record>(m_data[m_offset]) == LOAD)
+    {
+        m_offset++;
+        const auto name{ read_string(m_data, m_offset) };
+        if (name == std::nullopt)
+        {
+            slog::log(slog::WRN, "Recording ends part way through a load");
+            m_offset = m_data.size();
+            return std::nullopt;
+        }
+
+        frame.load = m_dir / name.value();
+    }
+
+    const auto remaining{ m_data.size() - m_offset };
+    if (remaining < sizeof(uint8_t) * 2 + sizeof(float))
+    {
+        return std::nullopt;
+    }
+
+    if (read<uint8_t>(m_data, m_offset) != FRAME)
+    {
+        slog::log(slog::WRN, "Recording has a record of an unknown kind, stopping there");
+        m_offset = m_data.size();
+        return std::nullopt;
+    }
+
+    unpack_buttons(frame.inputs, read<uint8_t>(m_data, m_offset));
+    frame.frame_time = read_float(m_data, m_offset);
+    if (frame.inputs.left_click || frame.inputs.right_click)
+    {
+        if (m_data.size() - m_offset < sizeof(float) * 4)
+        {
+            slog::log(slog::WRN, "Recording ends part way through a frame");
+            m_offset = m_data.size();
+            return std::nullopt;
+        }
+
+        frame.inputs.mouse_pos = sm::Vec2{ read_float(m_data, m_offset), read_float(m_data, m_offset) };
+        frame.inputs.mouse_world_pos = sm::Vec2{ read_float(m_data, m_offset), read_float(m_data, m_offset) };
+    }
+
+    return frame;
+}
+} // namespace replay
+
+namespace
+{
+auto pack_buttons(Inputs const& inputs) -> uint8_t
+{
+    uint8_t buttons{ 0 };
+    buttons |= (inputs.left ? LEFT : 0);
+    buttons |= (inputs.right ? RIGHT : 0);
+    buttons |= (inputs.up ? UP : 0);
+    buttons |= (inputs.down ? DOWN : 0);
+    buttons |= (inputs.left_click ? LEFT_CLICK : 0);
+    buttons |= (inputs.right_click ? RIGHT_CLICK : 0);
+    buttons |= (inputs.spawn_enemy ? SPAWN_ENEMY : 0);
+    buttons |= (inputs.pause ? PAUSE : 0);
+
+    return buttons;
+}
+
+auto unpack_buttons(Inputs& inputs, const uint8_t buttons) -> void
+{
+    inputs.left = (buttons & LEFT) != 0;
+    inputs.right = (buttons & RIGHT) != 0;
+    inputs.up = (buttons & UP) != 0;
+    inputs.down = (buttons & DOWN) != 0;
+    inputs.left_click = (buttons & LEFT_CLICK) != 0;
+    inputs.right_click = (buttons & RIGHT_CLICK) != 0;
+    inputs.spawn_enemy = (buttons & SPAWN_ENEMY) != 0;
+    inputs.pause = (buttons & PAUSE) != 0;
+}
+
+// values are written little endian, so recordings can be shared between machines
+template <std::unsigned_integral T>
+auto write(std::vector<std::byte>& buffer, const T value) -> void
+{
+    for (size_t i{ 0 }; i < sizeof(T); i++)
+    {
+        buffer.push_back(static_cast<std::byte>(value >> (i * 8)));
+    }
+}
+
+auto write(std::vector<std::byte>& buffer, const float value) -> void
+{
+    write(buffer, std::bit_cast<uint32_t>(value));
+}
+
+// written as its length followed by its bytes
+auto write(std::vector<std::byte>& buffer, const std::string_view value) -> void
+{
+    write(buffer, static_cast<uint16_t>(value.size()));
+    for (const auto c : value)
+    {
+        buffer.push_back(static_cast<std::byte>(c));
+    }
+}
+
+// the caller checks there are enough bytes left
+template <std::unsigned_integral T>
+auto read(const std::span<const std::byte> data, size_t& offset) -> T
+{
+    T value{ 0 };
+    for (size_t i{ 0 }; i < sizeof(T); i++)
+    {
+        value |= static_cast<T>(static_cast<T>(data[offset + i]) << (i * 8));
+    }
+
+    offset += sizeof(T);
+
+    return value;
+}
+
+auto read_float(const std::span<const std::byte> data, size_t& offset) -> float
+{
+    return std::bit_cast<float>(read<uint32_t>(data, offset));
+}
+
+// returns nullopt if the string runs past the end of the data
+auto read_string(const std::span<const std::byte> data, size_t& offset) -> std::optional<std::string>
+{
+    if (data.size() - offset < sizeof(uint16_t))
+    {
+        return std::nullopt;
+    }
+
+    const auto size{ read<uint16_t>(data, offset) };
+    if (data.size() - offset < size)
+    {
+        return std::nullopt;
+    }
+
+    std::string value(size, '\0');
+    for (size_t i{ 0 }; i < size; i++)
+    {
+        value[i] = static_cast<char>(data[offset + i]);
+    }
+
+    offset += size;
+
+    return value;
+}
+} // namespace
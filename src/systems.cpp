@@ -2,20 +2,24 @@
 #include "entities.hpp"
 #include "game.hpp"
 #include "se-bbox.hpp"
+#include "se-simd.hpp"
+#include "se-spatial.hpp"
 #include "se-sprite.hpp"
+#include "sl-alloc.hpp"
 #include "sl-log.hpp"
+#include "sl-profile.hpp"
 #include "sprites.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <concepts>
+#include <format>
 #include <initializer_list>
 #include <optional>
 #include <ranges>
 #include <type_traits>
 
 namespace ranges = std::ranges;
-namespace views = std::views;
 namespace rl = raylib;
 namespace sm = seblib::math;
 namespace slog = seblib::log;
@@ -43,6 +47,9 @@ inline constexpr float HEALTH_BAR_Y_OFFSET{ 8.0 };
 inline constexpr float INVULN_TIME{ 0.5 };
 inline constexpr float DAMAGE_LINE_THICKNESS{ 1.33 };
 
+// entities per job when a system splits its work across threads
+inline constexpr size_t PARALLEL_CHUNK_SIZE{ 4096 };
+
 namespace
 {
 template <typename S>
@@ -52,10 +59,10 @@ concept EntitySpritePart = std::same_as<S, SpriteBase>
     || std::same_as<S, SpriteLegs>
     || std::same_as<S, SpriteExtra>;
 
+auto sync_child(Game& game, size_t id, size_t parent_id) -> void;
 auto draw_sprite(Game& game, size_t id) -> void;
 template <EntitySpritePart Sprite>
 auto draw_sprite_part(Game& game, size_t id) -> void;
-auto mouse_screen_pos() -> seblib::math::Vec2;
 } // namespace
 
 auto Game::poll_inputs() -> void
@@ -64,26 +71,36 @@ auto Game::poll_inputs() -> void
     inputs.right = rl::Keyboard::IsKeyDown(::KEY_D);
     inputs.up = rl::Keyboard::IsKeyDown(::KEY_W);
     inputs.down = rl::Keyboard::IsKeyDown(::KEY_S);
-    inputs.left_click = rl::Mouse::IsButtonPressed(::MOUSE_LEFT_BUTTON);
-    inputs.right_click = rl::Mouse::IsButtonPressed(::MOUSE_RIGHT_BUTTON);
+    // clicks are held until a tick consumes them, as frames can pass without a tick
+    inputs.left_click = inputs.left_click || rl::Mouse::IsButtonPressed(::MOUSE_LEFT_BUTTON);
+    inputs.right_click = inputs.right_click || rl::Mouse::IsButtonPressed(::MOUSE_RIGHT_BUTTON);
     inputs.spawn_enemy = rl::Keyboard::IsKeyPressed(::KEY_P);
     inputs.pause = rl::Keyboard::IsKeyPressed(::KEY_ESCAPE);
+    inputs.mouse_pos = sm::Vec2{ rl::Mouse::GetPosition() };
+    inputs.mouse_world_pos = sm::Vec2{ camera.GetScreenToWorld(inputs.mouse_pos) } - SPRITE_SIZE / 2;
 }
 
 auto Game::render_sprites() -> void
 {
-    world.draw(texture_sheet, dt());
+    SL_PROFILE_ZONE("render_sprites");
+    world.draw(texture_sheet, frame_dt());
     for (const auto entity : ENTITY_RENDER_ORDER)
     {
         for (const auto id : entities.ids(entity))
         {
             auto comps{ components.by_id(id) };
-            const auto vel{ comps.get<se::Vel>() };
-            const auto pos{ comps.get<se::Pos>() };
-            sprites::lookup_set_movement_sprites(sprites, id, entity, vel);
+            const auto* vel{ comps.try_get<se::Vel>() };
+            const auto pos{ render_pos(id) };
+            sprites::lookup_set_movement_sprites(sprites, id, entity, vel != nullptr ? *vel : se::Vel{});
             draw_sprite(*this, id);
 
-            const auto health{ comps.get<Combat>().health };
+            const auto* combat{ comps.try_get<Combat>() };
+            if (combat == nullptr)
+            {
+                continue;
+            }
+
+            const auto health{ combat->health };
             if (health.max != std::nullopt && health.current != health.max)
             {
                 const auto hp_bar_pos{ pos - rl::Vector2{ 0.0, HEALTH_BAR_Y_OFFSET } };
@@ -103,8 +120,14 @@ auto Game::render_cboxes() -> void
     {
         for (const auto id : entities.ids(entity))
         {
-            const auto pos{ components.get<se::Pos>(id) };
-            const auto cbox{ components.get<se::BBox>(id).val(pos) };
+            const auto* bbox{ components.try_get<se::BBox>(id) };
+            if (bbox == nullptr)
+            {
+                continue;
+            }
+
+            const auto pos{ render_pos(id) };
+            const auto cbox{ bbox->val(pos) };
             seblib::match(
                 cbox,
                 [](const rl::Rectangle bbox)
@@ -135,8 +158,14 @@ auto Game::render_hitboxes() -> void
     {
         for (const auto id : entities.ids(entity))
         {
-            const auto pos{ components.get<se::Pos>(id) };
-            const auto hitbox{ components.get<Combat>(id).hitbox.val(pos) };
+            const auto* combat{ components.try_get<Combat>(id) };
+            if (combat == nullptr)
+            {
+                continue;
+            }
+
+            const auto pos{ render_pos(id) };
+            const auto hitbox{ combat->hitbox.val(pos) };
             seblib::match(
                 hitbox,
                 [](const rl::Rectangle bbox) { bbox.DrawLines(::GREEN); },
@@ -151,45 +180,83 @@ auto Game::render_hitboxes() -> void
 auto Game::set_player_vel() -> void
 {
     auto& player_vel{ components.get<se::Vel>(player_id) };
+    const auto prev_vel{ player_vel };
     player_vel.x = 0.0;
     player_vel.x += (inputs.right ? PLAYER_SPEED : 0.0F);
     player_vel.x -= (inputs.left ? PLAYER_SPEED : 0.0F);
     player_vel.y = 0.0;
     player_vel.y -= (inputs.up ? PLAYER_SPEED : 0.0F);
     player_vel.y += (inputs.down ? PLAYER_SPEED : 0.0F);
+    if (player_vel.x != prev_vel.x || player_vel.y != prev_vel.y)
+    {
+        components.mark_changed<se::Vel>(player_id);
+    }
 }
 
+// every entity with a velocity has a position, and velocities are zeroed when entities are destroyed, so the columns
+// can be integrated whole, a page at a time
 auto Game::move() -> void
 {
     auto& pos{ components.vec<se::Pos>() };
-    auto& vel{ components.vec<se::Vel>() };
-    ranges::transform(pos, vel, pos.begin(), [this](const auto pos, const auto vel) { return pos + (vel * dt()); });
+    auto const& vel{ components.vec<se::Vel>() };
+    jobs.parallel_for(
+        0,
+        std::min(pos.page_count(), vel.page_count()),
+        1,
+        [&pos, &vel, dt = dt()](const size_t first, const size_t last)
+        {
+            for (auto page{ first }; page < last; page++)
+            {
+                se::simd::integrate(pos.page(page), vel.page(page), dt);
+            }
+        }
+    );
+    components.par_each<se::Pos, se::Vel>(
+        jobs,
+        PARALLEL_CHUNK_SIZE,
+        [](size_t, se::Pos&, const se::Vel vel) { return vel.x != 0.0 || vel.y != 0.0; },
+        [this](const size_t id) { components.mark_changed<se::Pos>(id); }
+    );
 }
 
+// only the cboxes on the tiles under an entity are checked, in the order of the world's cboxes
+// being pushed out of one can move the entity onto tiles it wasn't over, so it looks again from the next cbox on
 auto Game::resolve_tile_collisions() -> void
 {
-    for (const auto [id, entity] : entities.vec() | views::enumerate)
+    auto const& tile_cboxes{ world.cboxes() };
+    auto& near_cboxes{ collision_scratch.near_cboxes };
+    for (const auto [id, pos, bbox] : components.view<se::Pos, se::BBox>())
     {
-        auto& pos{ components.get<se::Pos>(id) };
-        for (const auto tile_cbox : world.cboxes())
+        auto cbox{ bbox.val(pos) };
+        world.cboxes_in(se::bbox::bounds(cbox), near_cboxes);
+        size_t i{ 0 };
+        while (i < near_cboxes.size())
         {
-            const auto cbox{ components.get<se::BBox>(id).val(pos) };
-            if (se::bbox::collides(cbox, tile_cbox))
+            const auto cbox_id{ near_cboxes[i] };
+            i++;
+            if (!se::bbox::collides(cbox, tile_cboxes[cbox_id]))
             {
-                pos += se::bbox::resolve_collision(cbox, tile_cbox);
+                continue;
             }
+
+            pos += se::bbox::resolve_collision(cbox, tile_cboxes[cbox_id]);
+            components.mark_changed<se::Pos>(id);
+            cbox = bbox.val(pos);
+            world.cboxes_in(se::bbox::bounds(cbox), near_cboxes);
+            i = static_cast<size_t>(std::ranges::upper_bound(near_cboxes, cbox_id) - near_cboxes.begin());
         }
     }
 }
 
-auto Game::destroy_entities() -> void
+auto Game::apply_commands() -> void
 {
-    for (const auto id : to_destroy)
-    {
-        destroy_entity(id);
-    }
-
-    to_destroy.clear();
+    commands.apply(
+        entities,
+        components,
+        [this](const Entity type) { return spawn(type); },
+        [this](const size_t id, AttackSpawn const& spawn) { init_attack(id, spawn); },
+        [this](const size_t id) { destroy_entity(id); }
+    );
 }
 
 auto Game::player_action() -> void
@@ -201,7 +268,7 @@ auto Game::player_action() -> void
         attack_cooldown -= dt();
     }
 
-    const auto coords{ Coords::from_vec2(mouse_world_pos()) };
+    const auto coords{ Coords::from_vec2(inputs.mouse_world_pos) };
     if (inputs.left_click)
     {
         if (coords.has_value() && world.at(coords.value()) != Tile::None)
@@ -235,24 +302,44 @@ auto Game::player_action() -> void
 
 auto Game::update_lifespans() -> void
 {
-    for (const auto& [id, combat] : components.vec<Combat>() | views::enumerate)
-    {
-        auto& lifespan{ combat.lifespan };
-        if (lifespan == std::nullopt)
+    components.par_each<Combat>(
+        jobs,
+        PARALLEL_CHUNK_SIZE,
+        [dt = dt()](size_t, Combat& combat)
         {
-            continue;
-        }
+            auto& lifespan{ combat.lifespan };
+            if (lifespan == std::nullopt)
+            {
+                return false;
+            }
 
-        lifespan.value() -= dt();
-        if (lifespan.value() < 0.0)
-        {
-            to_destroy.push_back(id);
-        }
-    }
+            lifespan.value() -= dt;
+
+            return lifespan.value() < 0.0;
+        },
+        [this](const size_t id) { commands.destroy(entities.handle(id)); }
+    );
 }
 
+// each attack is only checked against the enemies sharing a cell with it, in the order of the enemy list, so which
+// enemies are hit is the same as checking every enemy
+// enemies which are already invulnerable stay so for the whole tick, so are left out
 auto Game::damage_entities() -> void
 {
+    auto const& enemy_ids{ entities.ids(Entity::Enemy) };
+    auto& [enemy_hitboxes, hit_candidates]{ hit_scratch };
+    enemy_hitboxes.clear();
+    for (size_t i{ 0 }; i < enemy_ids.size(); i++)
+    {
+        auto comps{ components.by_id(enemy_ids[i]) };
+        auto const& combat{ comps.get<Combat>() };
+        if (combat.invuln_time <= 0.0)
+        {
+            enemy_hitboxes.insert(i, se::bbox::bounds(combat.hitbox.val(comps.get<se::Pos>())));
+        }
+    }
+
+    enemy_hitboxes.build();
     for (const auto entity : DAMAGING_ENTITIES)
     {
         for (const auto id : entities.ids(entity))
@@ -260,8 +347,15 @@ auto Game::damage_entities() -> void
             auto comps{ components.by_id(id) };
             const auto pos{ comps.get<se::Pos>() };
             const auto projectile_bbox{ comps.get<Combat>().hitbox.val(pos) };
-            for (const auto enemy_id : entities.ids(Entity::Enemy))
+            hit_candidates.clear();
+            enemy_hitboxes.query(
+                se::bbox::bounds(projectile_bbox),
+                [&hit_candidates](const size_t index) { hit_candidates.push_back(index); }
+            );
+            ranges::sort(hit_candidates);
+            for (const auto index : hit_candidates)
             {
+                const auto enemy_id{ enemy_ids[index] };
                 auto& enemy_combat_comps{ components.by_id(enemy_id).get<Combat>() };
                 const auto enemy_pos{ components.by_id(enemy_id).get<se::Pos>() };
                 const auto enemy_bbox{ enemy_combat_comps.hitbox.val(enemy_pos) };
@@ -275,12 +369,12 @@ auto Game::damage_entities() -> void
                 enemy_current_health -= static_cast<int>(comps.get<Combat>().damage);
                 if (enemy_current_health <= 0)
                 {
-                    to_destroy.push_back(enemy_id);
+                    commands.destroy(entities.handle(enemy_id));
                 }
 
                 if (entity == Entity::Projectile)
                 {
-                    to_destroy.push_back(id);
+                    commands.destroy(entities.handle(id));
                     break;
                 }
 
@@ -291,59 +385,86 @@ auto Game::damage_entities() -> void
 }
 
 // child entities are assumed to have no velocity, this system will override it
+// children are only synced when they are attached, or when their parent's position or flags change
 auto Game::sync_children() -> void
 {
-    for (const auto [id, entity] : entities.vec() | views::enumerate)
-    {
-        auto comps{ components.by_id(id) };
-        if (comps.get<Parent>().id == std::nullopt)
-        {
-            continue;
-        }
+    const auto sync_with_parent{ [this](const size_t id)
+                                 {
+                                     const auto parent_id{ hierarchy.parent(id) };
+                                     if (parent_id != std::nullopt)
+                                     {
+                                         sync_child(*this, id, parent_id.value());
+                                     }
+                                 } };
+    const auto sync_all_children{ [this](const size_t id)
+                                  {
+                                      hierarchy.each_child(
+                                          id, [this, id](const size_t child_id) { sync_child(*this, child_id, id); }
+                                      );
+                                  } };
+    components.drain_changed<Parent>(children_parent_changes, sync_with_parent);
+    components.drain_changed<se::Pos>(children_pos_changes, sync_all_children);
+    components.drain_changed<Flags>(children_flags_changes, sync_all_children);
+}
 
-        const auto parent_id{ comps.get<Parent>().id.value() };
-        auto parent_comps{ components.by_id(parent_id) };
-        if (ranges::contains(FLIP_ON_SYNC_WITH_PARENT, entity))
+auto Game::update_invuln_times() -> void
+{
+    components.par_each<Combat>(
+        jobs,
+        PARALLEL_CHUNK_SIZE,
+        [dt = dt()](size_t, Combat& combat)
         {
-            const auto is_parent_flipped{ parent_comps.get<Flags>().is_enabled(Flags::FLIPPED) };
-            auto& flags{ comps.get<Flags>() };
-            flags.set(Flags::FLIPPED, is_parent_flipped);
-            if (entity == Entity::Melee)
+            auto& invuln_time{ combat.invuln_time };
+            if (invuln_time > 0.0)
             {
-                auto& combat{ comps.get<Combat>() };
-                const auto details{ std::get<MeleeDetails>(entities::attack_details(Attack::Melee).details) };
-                combat.hitbox = se::BBox{ details.size,
-                                          (flags.is_enabled(Flags::FLIPPED) ? MELEE_OFFSET_FLIPPED : MELEE_OFFSET) };
+                invuln_time -= dt;
             }
         }
-
-        auto& pos{ comps.get<se::Pos>() };
-        const auto parent_pos{ parent_comps.get<se::Pos>() };
-        pos = parent_pos;
-        slog::log(slog::TRC, "Child pos: ({}, {})", pos.x, pos.y);
-        slog::log(slog::TRC, "Parent pos: ({}, {})", parent_pos.x, parent_pos.y);
-    }
+    );
 }
 
-auto Game::update_invuln_times() -> void
+auto Game::render_ui() -> void
 {
-    for (const auto& [id, combat] : components.vec<Combat>() | views::enumerate)
+    SL_PROFILE_ZONE("render_ui");
+    if (screen != std::nullopt)
     {
-        auto& invuln_time{ combat.invuln_time };
-        if (invuln_time > 0.0)
-        {
-            invuln_time -= dt();
-        }
+        screen.value().render();
     }
 }
 
-auto Game::render_ui() -> void
+#ifdef SL_PROFILE
+// each zone's mean and max time per frame over the last frames, slowest first
+auto Game::render_profile() -> void
 {
-    if (screen != std::nullopt)
+    if (!show_profile)
     {
-        screen.value().render();
+        return;
+    }
+
+    SL_ALLOC_ALLOW();
+    const auto zones{ seblib::profile::frame_stats(PROFILE_FRAMES) };
+    const auto height{ static_cast<int>(zones.size() + 1) * PROFILE_LINE_HEIGHT };
+    ::DrawRectangle(0, 0, PROFILE_WIDTH, height + PROFILE_LINE_HEIGHT, ::Fade(::BLACK, 0.6F)); // NOLINT(*magic-numbers)
+    rl::DrawText(
+        std::format("zone (last {} frames)        mean      max", PROFILE_FRAMES),
+        PROFILE_LINE_HEIGHT / 2,
+        PROFILE_LINE_HEIGHT / 2,
+        PROFILE_FONT_SIZE,
+        ::WHITE
+    );
+    for (size_t i{ 0 }; i < zones.size(); i++)
+    {
+        auto const& zone{ zones[i] };
+        rl::DrawText(
+            std::format("{:<26} {:>7.3f}ms {:>7.3f}ms", zone.name, zone.mean_ms, zone.max_ms),
+            PROFILE_LINE_HEIGHT / 2,
+            (PROFILE_LINE_HEIGHT / 2) + (static_cast<int>(i + 1) * PROFILE_LINE_HEIGHT),
+            PROFILE_FONT_SIZE,
+            ::WHITE
+        );
     }
 }
+#endif
 
 auto Game::check_pause_game() -> void
 {
@@ -357,7 +478,7 @@ auto Game::ui_interaction() -> void
 {
     if (inputs.left_click && screen != std::nullopt)
     {
-        const auto action_performed{ screen->click_action(mouse_screen_pos()) };
+        const auto action_performed{ screen->click_action(inputs.mouse_pos) };
         if (action_performed)
         {
             // prevent in-game action if UI element clicked
@@ -368,23 +489,34 @@ auto Game::ui_interaction() -> void
 
 auto Game::set_flipped() -> void
 {
-    for (const auto [id, entity] : entities.vec() | views::enumerate)
-    {
-        auto comps{ components.by_id(id) };
-        auto& vel{ comps.get<se::Vel>() };
-        if (vel.x != 0.0 && !ranges::contains(NON_FLIPPABLE, entity))
+    components.drain_changed<se::Vel>(
+        flipped_vel_changes,
+        [this](const size_t id)
         {
-            components.get<Flags>(id).set(Flags::FLIPPED, vel.x < 0.0);
+            const auto vel{ components.get<se::Vel>(id) };
+            if (vel.x == 0.0 || ranges::contains(NON_FLIPPABLE, entities.vec()[id]))
+            {
+                return;
+            }
+
+            auto& flags{ components.get<Flags>(id) };
+            const auto flipped{ vel.x < 0.0 };
+            if (flags.is_enabled(Flags::FLIPPED) != flipped)
+            {
+                flags.set(Flags::FLIPPED, flipped);
+                components.mark_changed<Flags>(id);
+            }
         }
-    }
+    );
 }
 
 auto Game::render_damage_lines() -> void
 {
+    SL_PROFILE_ZONE("render_damage_lines");
     for (const auto id : entities.ids(Entity::DamageLine))
     {
         auto comps{ components.by_id(id) };
-        const auto pos{ comps.get<se::Pos>() };
+        const auto pos{ render_pos(id) };
         const auto line{ std::get<sm::Line>(comps.get<Combat>().hitbox.val(pos)) };
         ::DrawLineEx(line.pos1, line.pos2, DAMAGE_LINE_THICKNESS, ::LIGHTGRAY);
     }
@@ -392,6 +524,36 @@ auto Game::render_damage_lines() -> void
 
 namespace
 {
+auto sync_child(Game& game, const size_t id, const size_t parent_id) -> void
+{
+    auto& components{ game.components };
+    const auto entity{ game.entities.vec()[id] };
+    if (ranges::contains(FLIP_ON_SYNC_WITH_PARENT, entity))
+    {
+        const auto* parent_flags{ components.try_get<Flags>(parent_id) };
+        const auto is_parent_flipped{ parent_flags != nullptr && parent_flags->is_enabled(Flags::FLIPPED) };
+        auto& flags{ components.get<Flags>(id) };
+        if (flags.is_enabled(Flags::FLIPPED) != is_parent_flipped)
+        {
+            flags.set(Flags::FLIPPED, is_parent_flipped);
+            components.mark_changed<Flags>(id);
+            if (entity == Entity::Melee)
+            {
+                auto& combat{ components.get<Combat>(id) };
+                const auto details{ std::get<MeleeDetails>(entities::attack_details(Attack::Melee).details) };
+                combat.hitbox = se::BBox{ details.size, (is_parent_flipped ? MELEE_OFFSET_FLIPPED : MELEE_OFFSET) };
+            }
+        }
+    }
+
+    auto& pos{ components.get<se::Pos>(id) };
+    const auto parent_pos{ components.get<se::Pos>(parent_id) };
+    pos = parent_pos;
+    components.mark_changed<se::Pos>(id);
+    slog::log(slog::TRC, "Child pos: ({}, {})", pos.x, pos.y);
+    slog::log(slog::TRC, "Parent pos: ({}, {})", parent_pos.x, parent_pos.y);
+}
+
 auto draw_sprite(Game& game, const size_t id) -> void
 {
     draw_sprite_part<SpriteBase>(game, id);
@@ -404,13 +566,13 @@ auto draw_sprite(Game& game, const size_t id) -> void
 template <EntitySpritePart Sprite>
 auto draw_sprite_part(Game& game, const size_t id) -> void
 {
-    const auto pos{ game.components.get<se::Pos>(id) };
-    const auto flags{ game.components.get<Flags>(id) };
+    const auto pos{ game.render_pos(id) };
+    const auto* flags{ game.components.try_get<Flags>(id) };
     auto& sprites{ game.sprites };
-    const auto flipped{ flags.is_enabled(Flags::FLIPPED) };
+    const auto flipped{ flags != nullptr && flags->is_enabled(Flags::FLIPPED) };
     if constexpr (std::is_same_v<Sprite, SpriteLegs>)
     {
-        sprites.draw_part<Sprite>(game.texture_sheet, pos, id, game.dt(), flipped);
+        sprites.draw_part<Sprite>(game.texture_sheet, pos, id, game.frame_dt(), flipped);
     }
     else
     {
@@ -420,14 +582,7 @@ auto draw_sprite_part(Game& game, const size_t id) -> void
         const auto legs_frame{ sprites.current_frame<SpriteLegs>(id) };
         const auto y_offset{ (legs_frame % 2 == 0 ? 0.0F : sprites::alternate_frame_y_offset(legs)) };
         const rl::Vector2 offset{ x_offset, y_offset };
-        sprites.draw_part<Sprite>(game.texture_sheet, pos + offset, id, game.dt(), flipped);
+        sprites.draw_part<Sprite>(game.texture_sheet, pos + offset, id, game.frame_dt(), flipped);
     }
 }
-
-auto mouse_screen_pos() -> seblib::math::Vec2
-{
-    const auto mouse_pos{ rl::Mouse::GetPosition() };
-
-    return { mouse_pos.x, mouse_pos.y };
-}
 } // namespace
@@ -24,3 +24,16 @@ auto se::TileDetailsLookup<Tile, SpriteTile>::get(const Tile tile) -> se::TileDe
 
     std::unreachable();
 }
+
+template <>
+auto se::TileDetailsLookup<Tile, SpriteTile>::valid(const Tile tile) -> bool
+{
+    switch (tile)
+    {
+    case Tile::None:
+    case Tile::Brick:
+        return true;
+    }
+
+    return false;
+}